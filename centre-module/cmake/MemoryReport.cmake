@@ -0,0 +1,110 @@
+# Writes out how much flash and RAM each module uses, and fails the build if the image goes over budget.
+#
+# Run as a post build step with:
+#   SIZE         - the size tool for the toolchain.
+#   ELF          - the linked image.
+#   OBJECT_DIR   - where the object files for the target are built.
+#   REPORT       - the file to write the report to.
+#   FLASH_BUDGET - bytes of flash we allow the image, 0 for no limit.
+#   RAM_BUDGET   - bytes of RAM we allow the image, 0 for no limit.
+#
+# The module figures are from the object files, before unused sections are thrown away, so they are an upper bound.
+# The totals are from the linked image.
+
+# Reads the Berkeley format output of size into lists of text, data, bss and file names.
+function(read_sizes OUTPUT PREFIX)
+    string(REPLACE "\n" ";" LINES "${OUTPUT}")
+    set(TEXT "")
+    set(DATA "")
+    set(BSS "")
+    set(NAMES "")
+    foreach (LINE ${LINES})
+        if (LINE MATCHES "^[ \t]*([0-9]+)[ \t]+([0-9]+)[ \t]+([0-9]+)[ \t]+[0-9]+[ \t]+[0-9a-fA-F]+[ \t]+(.+)$")
+            list(APPEND TEXT ${CMAKE_MATCH_1})
+            list(APPEND DATA ${CMAKE_MATCH_2})
+            list(APPEND BSS ${CMAKE_MATCH_3})
+            get_filename_component(NAME "${CMAKE_MATCH_4}" NAME)
+            string(REGEX REPLACE "\\.(c|cpp|S)?\\.o(bj)?$" "" NAME "${NAME}")
+            list(APPEND NAMES ${NAME})
+        endif()
+    endforeach()
+    set(${PREFIX}_TEXT ${TEXT} PARENT_SCOPE)
+    set(${PREFIX}_DATA ${DATA} PARENT_SCOPE)
+    set(${PREFIX}_BSS ${BSS} PARENT_SCOPE)
+    set(${PREFIX}_NAMES ${NAMES} PARENT_SCOPE)
+endfunction()
+
+# Right align a number in a column.
+function(pad_number VALUE WIDTH RESULT)
+    set(PADDED "                    ${VALUE}")
+    string(LENGTH "${PADDED}" LENGTH)
+    math(EXPR START "${LENGTH} - ${WIDTH}")
+    string(SUBSTRING "${PADDED}" ${START} ${WIDTH} PADDED)
+    set(${RESULT} "${PADDED}" PARENT_SCOPE)
+endfunction()
+
+file(GLOB_RECURSE OBJECT_LIST "${OBJECT_DIR}/*.o" "${OBJECT_DIR}/*.obj")
+list(SORT OBJECT_LIST)
+
+execute_process(COMMAND ${SIZE} ${OBJECT_LIST} OUTPUT_VARIABLE MODULE_OUTPUT RESULT_VARIABLE MODULE_RESULT)
+execute_process(COMMAND ${SIZE} ${ELF} OUTPUT_VARIABLE IMAGE_OUTPUT RESULT_VARIABLE IMAGE_RESULT)
+
+if (NOT MODULE_RESULT EQUAL 0 OR NOT IMAGE_RESULT EQUAL 0)
+    message(FATAL_ERROR "Memory report: could not read the sizes")
+endif()
+
+read_sizes("${MODULE_OUTPUT}" MODULE)
+read_sizes("${IMAGE_OUTPUT}" IMAGE)
+
+set(REPORT_TEXT "Module                                       Flash      RAM\n")
+string(APPEND REPORT_TEXT "------------------------------------------------------------\n")
+
+list(LENGTH MODULE_NAMES MODULE_COUNT)
+if (MODULE_COUNT GREATER 0)
+    math(EXPR LAST "${MODULE_COUNT} - 1")
+    foreach (INDEX RANGE ${LAST})
+        list(GET MODULE_NAMES ${INDEX} NAME)
+        list(GET MODULE_TEXT ${INDEX} TEXT)
+        list(GET MODULE_DATA ${INDEX} DATA)
+        list(GET MODULE_BSS ${INDEX} BSS)
+
+        # Initialised data is stored in flash and copied to RAM, so it counts against both.
+        math(EXPR FLASH "${TEXT} + ${DATA}")
+        math(EXPR RAM "${DATA} + ${BSS}")
+
+        string(SUBSTRING "${NAME}                                        " 0 40 NAME_COLUMN)
+        pad_number(${FLASH} 10 FLASH_COLUMN)
+        pad_number(${RAM} 9 RAM_COLUMN)
+        string(APPEND REPORT_TEXT "${NAME_COLUMN}${FLASH_COLUMN}${RAM_COLUMN}\n")
+    endforeach()
+endif()
+
+list(GET IMAGE_TEXT 0 TEXT)
+list(GET IMAGE_DATA 0 DATA)
+list(GET IMAGE_BSS 0 BSS)
+math(EXPR IMAGE_FLASH "${TEXT} + ${DATA}")
+math(EXPR IMAGE_RAM "${DATA} + ${BSS}")
+
+pad_number(${IMAGE_FLASH} 10 FLASH_COLUMN)
+pad_number(${IMAGE_RAM} 9 RAM_COLUMN)
+string(APPEND REPORT_TEXT "------------------------------------------------------------\n")
+string(APPEND REPORT_TEXT "Image total                             ${FLASH_COLUMN}${RAM_COLUMN}\n")
+pad_number(${FLASH_BUDGET} 10 FLASH_COLUMN)
+pad_number(${RAM_BUDGET} 9 RAM_COLUMN)
+string(APPEND REPORT_TEXT "Budget                                  ${FLASH_COLUMN}${RAM_COLUMN}\n")
+
+file(WRITE ${REPORT} "${REPORT_TEXT}")
+message(STATUS "Memory report written to ${REPORT}: flash ${IMAGE_FLASH} bytes, RAM ${IMAGE_RAM} bytes.")
+
+set(OVER_BUDGET "")
+if (FLASH_BUDGET GREATER 0 AND IMAGE_FLASH GREATER FLASH_BUDGET)
+    list(APPEND OVER_BUDGET "flash ${IMAGE_FLASH} > ${FLASH_BUDGET}")
+endif()
+if (RAM_BUDGET GREATER 0 AND IMAGE_RAM GREATER RAM_BUDGET)
+    list(APPEND OVER_BUDGET "RAM ${IMAGE_RAM} > ${RAM_BUDGET}")
+endif()
+
+if (OVER_BUDGET)
+    file(REMOVE ${ELF})
+    message(FATAL_ERROR "Memory report: the image is over budget: ${OVER_BUDGET}. See ${REPORT}.")
+endif()
@@ -1,15 +1,15 @@
 #pragma once
 
 #include "IPicoInput.h"
+#include "ResponseCurve.h"
+#include <stddef.h>
 #include <stdint.h>
-#include <vector>
 
 
 class AnalogueInput
 {
   public:
 	AnalogueInput(uint32_t gpioSwitchId) : gpioSwitchId(gpioSwitchId){};
-	virtual ~AnalogueInput(){};
 
 	// Minimum value returned by the ADC.
 	const static int16_t minADCValue{0};
@@ -23,12 +23,15 @@ class AnalogueInput
 	// The GPIO pin number which the switch is connected to.
 	uint32_t gpioSwitchId;
 
-	// Convert the raw value to something useful to XInput.
+	// Convert the raw value to something useful to XInput, through the response curve.
 	int8_t GetXBoxValue() const
 	{
-		return static_cast<int8_t>((value - midPointADCValue) >> 4);
+		return responseCurve[value & (kResponseCurveTableSize - 1)];
 	};
 
+	// Maps each ADC code to an XInput value.
+	const int8_t *responseCurve{GetResponseCurve(kResponseCurveLinear)};
+
 	// Value measured at the ADC input.
 	int16_t value{midPointADCValue};
 
@@ -46,6 +49,9 @@ class AnalogueInputGroup : IPicoInput
 	// Call to initialise.
 	virtual void Init() override;
 
+	// Print the pin assignments over the UART.
+	void PrintDiagnostics();
+
 	// Called each frame to process the inputs.
 	// Returns true if the state has changed.
 	virtual bool OnTask() override;
@@ -56,6 +62,12 @@ class AnalogueInputGroup : IPicoInput
 		return true;
 	};
 
+	// The number of axes in use.
+	size_t GetAxisCount() const
+	{
+		return kPinCount;
+	};
+
 	// Get the raw value read from the analogue pin. Using 0-3 as pin IDs.
 	int16_t GetRawValue(size_t pinID) const
 	{
@@ -68,6 +80,12 @@ class AnalogueInputGroup : IPicoInput
 		return analogueInputs[pinID].GetXBoxValue();
 	};
 
+	// Pick the response curve for an axis.
+	void SetResponseCurve(size_t pinID, ResponseCurveID curveID)
+	{
+		analogueInputs[pinID].responseCurve = GetResponseCurve(curveID);
+	};
+
   private:
 	// Has a digital switch been pressed this frame?
 	bool hasStateChanged = false;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdint.h>
+
+
+// The phases of start-up we take a timestamp for.
+enum BootPhase
+{
+	kBootPhaseMainEntered,
+	kBootPhaseUSBStarted,
+	kBootPhaseDigitalReady,
+	kBootPhaseMounted,
+	kBootPhaseFirstReport,
+	kBootPhaseDeferredInit,
+	kBootPhaseCount
+};
+
+
+class BootProfile
+{
+  public:
+	// Record the time we reached a phase. Only the first mark for each phase is kept.
+	void Mark(BootPhase phase);
+
+	// Has this phase been reached yet?
+	bool HasReached(BootPhase phase) const
+	{
+		return (reachedPhases & (1U << phase)) != 0;
+	};
+
+	// Microseconds from the timer starting up to reaching the phase. Only valid if the phase was reached.
+	uint32_t GetTime(BootPhase phase) const
+	{
+		return phaseTimes[phase];
+	};
+
+	// Dump the timings over the UART.
+	void Print() const;
+
+  private:
+	// A bitmap of the phases we have reached.
+	uint32_t reachedPhases{0};
+
+	// Time at which each phase was reached.
+	uint32_t phaseTimes[kBootPhaseCount]{};
+};
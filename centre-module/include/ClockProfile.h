@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// The clock profiles we can run at.
+enum ClockProfileID
+{
+	kClockProfileIdle,
+	kClockProfileStandard,
+	kClockProfileCompetition,
+	kClockProfileCount
+};
+
+
+// Measurements taken while running at a profile.
+struct ClockProfileStats
+{
+	// Loops of the main task in the last full second at this profile.
+	uint32_t loopsPerSecond{0};
+
+	// Time from a switch change being scanned to its report being queued.
+	uint32_t minLatencyUS{UINT32_MAX};
+	uint32_t maxLatencyUS{0};
+	uint64_t totalLatencyUS{0};
+	uint32_t latencyCount{0};
+};
+
+
+class ClockProfiles
+{
+  public:
+	// Call to initialise, before the UART and SPI are set up. Moves the peripheral clock onto the USB PLL so the baud
+	// rates don't change with the profile. USB and the ADC already run from the USB PLL.
+	void Init();
+
+	// Switch to a new profile. Returns true if the system clock was changed.
+	bool Select(ClockProfileID profileID);
+
+	// The profile we are running at.
+	ClockProfileID GetCurrent() const
+	{
+		return currentProfile;
+	};
+
+	// The system clock for the current profile.
+	uint32_t GetSysClockKHz() const;
+
+	// Call once each time round the main loop.
+	void OnLoop()
+	{
+		loopCount++;
+	};
+
+	// Call when a report carrying an input change has been queued.
+	void OnReport(uint32_t inputTime, uint32_t reportTime);
+
+	// Called each frame, works out the loop rate once a second and prints the stats every so often.
+	void OnTask();
+
+	// Dump the measurements for every profile over the UART.
+	void PrintStats() const;
+
+  private:
+	// The profile we are running at.
+	ClockProfileID currentProfile{kClockProfileStandard};
+
+	// Loops since the start of the measurement window.
+	uint32_t loopCount{0};
+
+	// When the measurement window started.
+	uint32_t windowStartTime{0};
+
+	// Windows since the stats were last printed.
+	uint32_t windowCount{0};
+
+	// Measurements for each profile.
+	ClockProfileStats stats[kClockProfileCount];
+};
@@ -1,17 +1,17 @@
 #pragma once
 
 #include "IPicoInput.h"
+#include "InputBitset.h"
+#include "PanelLayout.h"
 #include <stdint.h>
 #include <stdlib.h>
-#include <string>
 
 
 class DigitalInput
 {
   public:
-	DigitalInput(uint32_t gpioSwitchId, int mappedKey, std::string mappedKeyName)
-	    : gpioSwitchId(gpioSwitchId), mappedKey(mappedKey), mappedKeyName(mappedKeyName){};
-	virtual ~DigitalInput(){};
+	DigitalInput(uint32_t gpioSwitchId, int mappedKey, const char *mappedKeyName, uint8_t player = 0)
+	    : gpioSwitchId(gpioSwitchId), mappedKey(mappedKey), mappedKeyName(mappedKeyName), player(player){};
 
 	// The GPIO pin number which the switch is connected to.
 	uint32_t gpioSwitchId;
@@ -19,8 +19,11 @@ class DigitalInput
 	// The key code we will send when activating this switch?
 	int mappedKey;
 
-	// Friendly name for the switch.
-	std::string mappedKeyName;
+	// Friendly name for the switch. This points into flash.
+	const char *mappedKeyName;
+
+	// The player the switch belongs to, which decides the gamepad it is reported on.
+	uint8_t player;
 
 	// Is the switch currently depressed?
 	bool isPressed;
@@ -33,11 +36,24 @@ class DigitalInput
 class DigitalInputGroup : IPicoInput
 {
   public:
-	const size_t kDigitalInputCount = 21;
+	// The most inputs the group can track.
+	const static size_t kMaxInputCount{64};
+
+	// The number of players, each with their own gamepad.
+	const static size_t kPlayerCount{PANEL_PLAYER_COUNT};
 
 	// Call to initialise.
 	virtual void Init() override;
 
+	// Print the pin assignments over the UART.
+	void PrintDiagnostics();
+
+	// Stop any switches on these pins being used, they belong to something else. Call before Init.
+	void ReservePins(uint32_t mask)
+	{
+		reservedMask |= mask;
+	};
+
 	// Called each frame to process the inputs.
 	// Returns true if the state has changed.
 	virtual bool OnTask() override;
@@ -45,13 +61,76 @@ class DigitalInputGroup : IPicoInput
 	// True if our state has changed this frame.
 	virtual bool HasStateChanged() override;
 
-	// Get the current state of the digital switches as a bitset.
-	uint32_t GetState();
+	// True if the state for this player has changed this frame.
+	bool HasStateChanged(size_t player) const
+	{
+		return (changedPlayers & (1U << player)) != 0;
+	};
+
+	// Get the current state of a player's gamepad buttons as a bitset.
+	uint32_t GetState(size_t player = 0) const
+	{
+		return playerButtons[player];
+	};
+
+	// When the last change of any input was scanned.
+	uint32_t GetLastChangeTime() const
+	{
+		return lastChangeTime;
+	};
+
+	// The pressed state of every input, indexed by its position in the switch table.
+	const InputBitset<kMaxInputCount> &GetInputStates() const
+	{
+		return inputStates;
+	};
+
+	// The inputs which changed this frame.
+	const InputBitset<kMaxInputCount> &GetChangedInputs() const
+	{
+		return changedInputs;
+	};
+
+	// The number of switches in the layout.
+	size_t GetInputCount() const;
+
+	// The GPIO a switch is wired to.
+	uint32_t GetInputGPIO(size_t input) const;
+
+	// False if the switch's pin has been reserved for something else, so it can never change.
+	bool IsInputInUse(size_t input) const;
+
+	// A name for the switch, for printing.
+	const char *GetInputName(size_t input) const;
 
   private:
-	// Has a digital switch been pressed this frame?
-	bool hasStateChanged = false;
+	// Marks an input which isn't attached to a GPIO.
+	const static uint8_t kNoInput{0xFF};
+
+	// A bitmap of the GPIO pins which have a switch attached.
+	uint32_t gpioMask = 0;
+
+	// A bitmap of the GPIO pins taken by other inputs.
+	uint32_t reservedMask = 0;
+
+	// The GPIO values from the last frame, for spotting the edges.
+	uint32_t lastGPIOState = 0;
+
+	// When the last change of any input was scanned.
+	uint32_t lastChangeTime = 0;
 
-	// A bitmap of the state of all the digital switches on a gamepad.
-	uint32_t digitalSwitches = 0;
-};
\ No newline at end of file
+	// Which input is attached to each GPIO pin.
+	uint8_t gpioToInput[32]{};
+
+	// The pressed state of every input.
+	InputBitset<kMaxInputCount> inputStates;
+
+	// The inputs which changed this frame.
+	InputBitset<kMaxInputCount> changedInputs;
+
+	// A bitmap of the players whose state has changed this frame.
+	uint32_t changedPlayers = 0;
+
+	// A bitmap of the state of all the digital switches on each player's gamepad.
+	uint32_t playerButtons[kPlayerCount]{};
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// A fixed size set of input states, one bit for each input.
+template <size_t kBitCount> class InputBitset
+{
+  public:
+	// The number of 32 bit words needed to hold the bits.
+	const static size_t kWordCount{(kBitCount + 31) / 32};
+
+	bool Test(size_t bit) const
+	{
+		return (words[bit >> 5] & (1U << (bit & 31))) != 0;
+	};
+
+	void Set(size_t bit)
+	{
+		words[bit >> 5] |= (1U << (bit & 31));
+	};
+
+	void Reset(size_t bit)
+	{
+		words[bit >> 5] &= ~(1U << (bit & 31));
+	};
+
+	// Clear all the bits.
+	void ResetAll()
+	{
+		for (size_t i = 0; i < kWordCount; i++)
+			words[i] = 0;
+	};
+
+	// True if any of the bits are set.
+	bool Any() const
+	{
+		for (size_t i = 0; i < kWordCount; i++)
+		{
+			if (words[i])
+				return true;
+		}
+
+		return false;
+	};
+
+	uint32_t GetWord(size_t word) const
+	{
+		return words[word];
+	};
+
+	// Call the function with the index of each set bit, lowest first. This costs one step for each word and one for
+	// each set bit, so a sparse set is cheap however wide it is.
+	template <typename Function> void ForEachSetBit(Function function) const
+	{
+		for (size_t i = 0; i < kWordCount; i++)
+		{
+			for (uint32_t bits = words[i]; bits; bits &= bits - 1)
+				function(i * 32 + __builtin_ctz(bits));
+		}
+	};
+
+  private:
+	uint32_t words[kWordCount]{};
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "tusb.h"
+#include <stddef.h>
+#include <stdint.h>
+
+
+// A gamepad report as it was sent to the host, and when.
+struct InputSnapshot
+{
+	uint32_t timeUS;
+	uint8_t player;
+	hid_gamepad_report_t report;
+};
+
+
+// Which parts of a snapshot are in the feature report.
+enum InputSnapshotFields
+{
+	kInputSnapshotPlayer = 0x01,
+	kInputSnapshotButtons = 0x02,
+	kInputSnapshotX = 0x04,
+	kInputSnapshotY = 0x08,
+	kInputSnapshotZ = 0x10,
+	kInputSnapshotRz = 0x20,
+	kInputSnapshotRx = 0x40,
+	kInputSnapshotRy = 0x80,
+};
+
+
+// The last few hundred gamepad reports which carried a change, for input display overlays and for working out what
+// happened after the fact. Recording one is a copy into the ring and a bump of the write position.
+//
+// The history is read in pages through a feature report. Getting the report returns the page at the read position
+// and leaves it where it is, so a lost or repeated GET_REPORT doesn't lose snapshots. Setting the report moves it:
+//   bytes 0-3 - the sequence number to read from next. Anything older than the history holds starts at the oldest.
+// To read the next page, set the first sequence number of the page just read plus its snapshot count.
+// Getting the report returns:
+//   bytes 0-3 - the sequence number of the first snapshot in the page.
+//   bytes 4-7 - the sequence number the next snapshot recorded will get.
+//   byte 8    - the number of snapshots in the page.
+//   then for each snapshot, little endian:
+//     fields (1)   - InputSnapshotFields. The player bit is the player, the rest say which of the parts below follow.
+//     time (1-5)   - us since the snapshot before in the page, or since 0 for the first, 7 bits a byte with the top
+//                    bit set on all but the last.
+//     buttons (4) and hat (1), then x, y, z, rz, rx, ry (1 each) - only those which differ from the player's snapshot
+//                    before in the page. A player's first snapshot in the page has them all.
+// A snapshot takes 17 bytes at most, and one changing a button or an axis takes 4-10. A 63 byte page of ordinary play
+// holds about 6, so reading the whole ring takes around 43 SET and GET round trips.
+class InputHistory
+{
+  public:
+	// Snapshots kept. A power of two, so the ring wraps with a mask.
+	const static uint32_t kSnapshotCount{256};
+	static_assert((kSnapshotCount & (kSnapshotCount - 1)) == 0, "The history must be a power of two long");
+
+	// Players the snapshots can tell apart.
+	const static uint8_t kPlayerCount{2};
+
+	// The most bytes a snapshot can take in the feature report.
+	const static size_t kMaxReportBytesPerSnapshot{17};
+
+	// The bytes before the first snapshot in the feature report.
+	const static size_t kReportHeaderBytes{9};
+
+	// Keep a report the player's gamepad has sent.
+	void Record(uint8_t player, const hid_gamepad_report_t &report, uint32_t timeUS)
+	{
+		InputSnapshot &snapshot = snapshots[writeSequence & (kSnapshotCount - 1)];
+		snapshot.timeUS = timeUS;
+		snapshot.player = player;
+		snapshot.report = report;
+		writeSequence++;
+	};
+
+	// The sequence number the next snapshot will get. It counts every snapshot ever recorded.
+	uint32_t GetWriteSequence() const
+	{
+		return writeSequence;
+	};
+
+	// Fill in the feature report. Returns the number of bytes written.
+	uint16_t GetReport(uint8_t *buffer, uint16_t length) const;
+
+	// Handle the feature report being set.
+	void SetReport(const uint8_t *buffer, uint16_t length);
+
+	// For the host, read the snapshots out of a page of the feature report. Returns the number read, which is less
+	// than the page says if the page is cut short or there isn't room for them all.
+	static uint32_t DecodeReport(const uint8_t *buffer, uint16_t length, InputSnapshot *pageSnapshots,
+	                             uint32_t maxCount);
+
+  private:
+	InputSnapshot snapshots[kSnapshotCount]{};
+
+	// Where the next snapshot is written.
+	uint32_t writeSequence{0};
+
+	// Where the feature report reads from, until the host moves it on.
+	uint32_t readSequence{0};
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "ReportBytes.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// What the device sends back for a probe.
+struct LatencyProbeEcho
+{
+	// Copied from the probe.
+	uint32_t sequence;
+	uint32_t hostTime;
+
+	// When the probe arrived and when the echo went out, on our clock.
+	uint32_t receiveTimeUS;
+	uint32_t sendTimeUS;
+
+	// The latest time from a switch changing on the scan to the report carrying it going out, and how many of those
+	// have been measured so the host can tell a new one from the last.
+	uint32_t scanToReportUS;
+	uint32_t scanToReportCount;
+};
+
+
+// Measures the device's share of the input lag. The host sends a probe as a feature or output report, we stamp when it
+// arrived and echo it back in the next IN report, along with the latest scan-to-report time.
+//
+// The echo is an IN report of its own, so it takes the first interface's next poll away from the gamepad. To keep that
+// from showing up in what it measures, an echo waits while a switch change is still to be reported, and goes out at
+// most once every kMinEchoIntervalUS. At the 5ms polling interval that's at most one poll in ten, and a probe sent
+// sooner than that after the last echo has the wait counted in the firmware's turnaround.
+//
+// Both go in the REPORT_ID_LATENCY_PROBE report, little endian. The probe is the sequence number (4) and the host's
+// send time (4), in whatever units the host likes. The echo is the fields of LatencyProbeEcho in order, 4 bytes each.
+class LatencyProbe
+{
+  public:
+	// The size of the probe and the echo, not counting the report ID.
+	const static size_t kProbeBytes{8};
+	const static size_t kEchoBytes{24};
+
+	// The shortest time between echoes.
+	const static uint32_t kMinEchoIntervalUS{50000};
+
+	// Call when a probe arrives, as soon as possible.
+	void OnProbe(const uint8_t *buffer, uint16_t length);
+
+	// Call when a report carrying a switch change has been sent.
+	void OnReport(uint32_t inputTime, uint32_t reportTime)
+	{
+		scanToReportUS = reportTime - inputTime;
+		scanToReportCount++;
+	};
+
+	// True if there's a probe waiting for its echo and it's long enough since the last one went out.
+	bool IsEchoDue(uint32_t currentTimeUS) const
+	{
+		return isProbePending && (!hasSentEcho || currentTimeUS - lastEchoTimeUS >= kMinEchoIntervalUS);
+	};
+
+	// Fill in the echo for the waiting probe, going out at this time.
+	void GetEcho(uint8_t *buffer, uint32_t sendTimeUS) const;
+
+	// Call once the echo has been sent.
+	void OnEchoSent(uint32_t sendTimeUS)
+	{
+		isProbePending = false;
+		hasSentEcho = true;
+		lastEchoTimeUS = sendTimeUS;
+	};
+
+	// For the host, write a probe.
+	static void EncodeProbe(uint8_t *buffer, uint32_t sequence, uint32_t hostTime)
+	{
+		WriteUInt32(buffer, sequence);
+		WriteUInt32(buffer + 4, hostTime);
+	};
+
+	// For the host, read an echo.
+	static void DecodeEcho(const uint8_t *buffer, LatencyProbeEcho &echo)
+	{
+		echo.sequence = ReadUInt32(buffer);
+		echo.hostTime = ReadUInt32(buffer + 4);
+		echo.receiveTimeUS = ReadUInt32(buffer + 8);
+		echo.sendTimeUS = ReadUInt32(buffer + 12);
+		echo.scanToReportUS = ReadUInt32(buffer + 16);
+		echo.scanToReportCount = ReadUInt32(buffer + 20);
+	};
+
+  private:
+	// The probe waiting for its echo.
+	bool isProbePending{false};
+	uint32_t probeSequence{0};
+	uint32_t probeHostTime{0};
+	uint32_t probeReceiveTimeUS{0};
+
+	// When the last echo went out.
+	bool hasSentEcho{false};
+	uint32_t lastEchoTimeUS{0};
+
+	// The latest scan-to-report time.
+	uint32_t scanToReportUS{0};
+	uint32_t scanToReportCount{0};
+};
@@ -0,0 +1,14 @@
+#ifndef PANEL_LAYOUT_H_
+#define PANEL_LAYOUT_H_
+
+// The number of players on the panel. Each player gets their own gamepad HID instance.
+#ifndef PANEL_PLAYER_COUNT
+#define PANEL_PLAYER_COUNT 1
+#endif
+
+// There are only enough GPIO pins for two players' sticks and buttons. More would need the switches multiplexing.
+#if PANEL_PLAYER_COUNT < 1 || PANEL_PLAYER_COUNT > 2
+#error "PANEL_PLAYER_COUNT must be 1 or 2"
+#endif
+
+#endif
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "IPicoInput.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#if QUADRATURE && PANEL_PLAYER_COUNT != 1
+#error "The encoder pins are only free in the one player switch layout"
+#endif
+
+
+// Where the motion from an encoder ends up.
+enum QuadratureOutput
+{
+	kQuadratureOutputMouseX,
+	kQuadratureOutputMouseY,
+	kQuadratureOutputGamepadZ,
+	kQuadratureOutputGamepadRz,
+};
+
+
+class QuadratureInput
+{
+  public:
+	QuadratureInput(uint32_t gpioPinA, QuadratureOutput output, int32_t countsPerStep)
+	    : gpioPinA(gpioPinA), output(output), countsPerStep(countsPerStep){};
+
+	// The GPIO pin for the A phase. The B phase must be on the next pin up.
+	uint32_t gpioPinA;
+
+	// Where the motion is sent.
+	QuadratureOutput output;
+
+	// Encoder counts for each step sent to the host. 4 is one step for each line on the encoder wheel.
+	int32_t countsPerStep;
+
+	// The PIO state machine doing the counting.
+	uint32_t stateMachine{0};
+
+	// The last count read back from the state machine.
+	int32_t count{0};
+
+	// Counts we have seen but not yet sent to the host.
+	int32_t pendingCounts{0};
+
+	// Whole steps ready to be sent, clamped to what fits in a report. The remainder stays pending for the next one.
+	int8_t GetPendingSteps() const
+	{
+		const int32_t steps = pendingCounts / countsPerStep;
+		return static_cast<int8_t>(steps > 127 ? 127 : (steps < -127 ? -127 : steps));
+	};
+
+	// Call once the steps have made it into a report.
+	void ConsumeSteps(int8_t steps)
+	{
+		pendingCounts -= steps * countsPerStep;
+	};
+
+	// Position as an axis. This wraps round, which suits a spinner.
+	int8_t GetPosition() const
+	{
+		return static_cast<int8_t>(count / countsPerStep);
+	};
+};
+
+
+class QuadratureInputGroup : IPicoInput
+{
+  public:
+	// The number of encoders attached.
+	const static size_t kEncoderCount{1};
+
+	// Call to initialise.
+	virtual void Init() override;
+
+	// Print the pin assignments over the UART.
+	void PrintDiagnostics();
+
+	// Called each frame to process the inputs.
+	// Returns true if the state has changed.
+	virtual bool OnTask() override;
+
+	// True if our state has changed this frame.
+	virtual bool HasStateChanged() override
+	{
+		return hasStateChanged;
+	};
+
+	// A bitmap of the GPIO pins the encoders use. These can't also be used for switches.
+	uint32_t GetGPIOMask() const;
+
+	// Is any encoder sending its motion to this output?
+	bool HasOutput(QuadratureOutput output) const;
+
+	// Whole steps waiting to be sent to this output.
+	int8_t GetPendingSteps(QuadratureOutput output) const;
+
+	// Call once the steps for this output have made it into a report.
+	void ConsumeSteps(QuadratureOutput output, int8_t steps);
+
+	// Position of the encoder for this output as an axis.
+	int8_t GetPosition(QuadratureOutput output) const;
+
+  private:
+	// Has an encoder moved this frame?
+	bool hasStateChanged = false;
+
+	// A spinner on GPIO 14 and 15, the unlabelled left panel pins in the one player layout. The two player layout has
+	// switches on every pin from 2 to 21, so there's no pair left for an encoder. A trackball needs a second encoder
+	// for Y e.g. {20, kQuadratureOutputMouseY, 4} in place of the front panel buttons.
+	QuadratureInput encoders[kEncoderCount]{{14, kQuadratureOutputMouseX, 4}};
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Reading and writing the vendor defined reports. Everything in them is little endian, whatever the host is.
+
+// Each write returns where the next field goes.
+static inline uint8_t *WriteUInt16(uint8_t *buffer, uint16_t value)
+{
+	buffer[0] = static_cast<uint8_t>(value);
+	buffer[1] = static_cast<uint8_t>(value >> 8);
+	return buffer + 2;
+}
+
+
+static inline uint8_t *WriteUInt32(uint8_t *buffer, uint32_t value)
+{
+	buffer[0] = static_cast<uint8_t>(value);
+	buffer[1] = static_cast<uint8_t>(value >> 8);
+	buffer[2] = static_cast<uint8_t>(value >> 16);
+	buffer[3] = static_cast<uint8_t>(value >> 24);
+	return buffer + 4;
+}
+
+
+static inline uint16_t ReadUInt16(const uint8_t *buffer)
+{
+	return static_cast<uint16_t>(buffer[0] | (buffer[1] << 8));
+}
+
+
+static inline uint32_t ReadUInt32(const uint8_t *buffer)
+{
+	return buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | (static_cast<uint32_t>(buffer[3]) << 24);
+}
+
+
+// GET_REPORT hands back as many bytes as the host asked for, so zero everything from write to the end of the buffer
+// rather than sending whatever was left in it. Returns the full length, ready to give back to TinyUSB.
+static inline uint16_t PadReport(uint8_t *buffer, uint8_t *write, uint16_t length)
+{
+	while (write < buffer + length)
+		*write++ = 0;
+
+	return length;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// The shapes of stick response we can pick from.
+enum ResponseCurveID
+{
+	kResponseCurveLinear,
+	kResponseCurveExponential,
+	kResponseCurveSCurve,
+	kResponseCurveAntiDeadzone,
+	kResponseCurveCount
+};
+
+
+// One entry for each 12 bit ADC code.
+const size_t kResponseCurveTableSize{4096};
+
+// The ADC code for a centred stick.
+const int32_t kResponseCurveMidPoint{kResponseCurveTableSize / 2};
+
+
+// The XInput value for every ADC code.
+struct ResponseCurveTable
+{
+	int8_t values[kResponseCurveTableSize];
+};
+
+
+// The curves take the stick position from -1 to 1 and return the output from -1 to 1. They are only ever run at build
+// time, so there's no cost to using floats on a part without an FPU.
+
+constexpr float LinearResponse(float x)
+{
+	return x;
+}
+
+
+// Soft around the centre for fine aiming, speeding up towards the edges. A blend of linear and cubic.
+constexpr float ExponentialResponse(float x)
+{
+	const float kExpo = 0.6f;
+	return (1.0f - kExpo) * x + kExpo * x * x * x;
+}
+
+
+// Soft at the centre and the edges, quick through the middle of the travel.
+constexpr float SCurveResponse(float x)
+{
+	const float t = x < 0.0f ? -x : x;
+	const float y = t * t * (3.0f - 2.0f * t);
+	return x < 0.0f ? -y : y;
+}
+
+
+// Jumps straight past the deadzone most games put round the centre, so the smallest movement registers.
+constexpr float AntiDeadzoneResponse(float x)
+{
+	const float kDeadzone = 0.2f;
+
+	// Keep a little dead spot of our own so the noise on a centred stick doesn't leak through.
+	const float kNoise = 0.02f;
+
+	const float t = x < 0.0f ? -x : x;
+	if (t < kNoise)
+		return 0.0f;
+
+	const float y = kDeadzone + (1.0f - kDeadzone) * (t - kNoise) / (1.0f - kNoise);
+	return x < 0.0f ? -y : y;
+}
+
+
+// Expand a curve into a table. The output is floored to match the shift the linear mapping has always used.
+constexpr ResponseCurveTable MakeResponseCurveTable(float (*curve)(float))
+{
+	ResponseCurveTable table{};
+
+	for (size_t code = 0; code < kResponseCurveTableSize; code++)
+	{
+		const float x = static_cast<float>(static_cast<int32_t>(code) - kResponseCurveMidPoint) / kResponseCurveMidPoint;
+		const float scaled = curve(x) * 128.0f;
+
+		int32_t value = static_cast<int32_t>(scaled);
+		if (scaled < value)
+			value--;
+
+		table.values[code] = static_cast<int8_t>(value > 127 ? 127 : (value < -128 ? -128 : value));
+	}
+
+	return table;
+}
+
+
+// The table for a curve. These live in flash.
+const int8_t *GetResponseCurve(ResponseCurveID curveID);
+
+// Friendly name for a curve.
+const char *GetResponseCurveName(ResponseCurveID curveID);
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "AnalogueInput.h"
+#include "IPicoInput.h"
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Analogue inputs read from an MCP3208 (8 channel, 12 bit) on SPI. Conversions are clocked out by DMA at a fixed
+// sample rate with no help from the CPU; OnTask only decodes the latest sweep.
+//
+// A timer paced DMA channel writes to the multi-channel trigger register, kicking off a TX / RX pair which clocks one
+// conversion through the SPI. Their addresses ring around the command and sample buffers so the next trigger moves on
+// to the next channel. The SPI runs in mode 3 (CPOL=1, CPHA=1) so the hardware chip select stays low for the whole
+// conversion and is released when the TX FIFO runs dry, between timer ticks.
+//
+// Throughput: each conversion is 32 SPI clocks. At the 1MHz the MCP3208 is rated for at 3.3V that is 32us, so the bus
+// tops out at ~31k conversions a second, or ~3.9kHz for a sweep of all 8 channels. The default 1kHz sweep of 8
+// channels uses about a quarter of that. The measured rate is printed whenever the clock profile changes.
+class SPIAnalogueInputGroup : IPicoInput
+{
+  public:
+	// The number of channels on an MCP3208.
+	const static size_t kMaxAxisCount{8};
+
+	// Two sticks and a pair of pedals. The firmware sets it with CENTRE_MODULE_SPI_ADC_AXIS_COUNT.
+	const static size_t kDefaultAxisCount{6};
+
+	// Full sweeps of all the axes per second.
+	const static uint32_t kDefaultSampleRateHz{1000};
+
+	// Bytes clocked for a single conversion. The MCP3208 needs 24 clocks, we send a leading zero byte to make it 32 so
+	// each slot in the buffers is a power of two.
+	const static size_t kBytesPerConversion{4};
+
+	// Size of the command and sample buffers.
+	const static size_t kBufferSize{kMaxAxisCount * kBytesPerConversion};
+
+	// SPI clock rate.
+	const static uint32_t kBaudRate{1000000};
+
+	// SPI1 pins. These take over the pins used by the internal ADC.
+	const static uint32_t kPinSCK{26};
+	const static uint32_t kPinTX{27};
+	const static uint32_t kPinRX{28};
+	const static uint32_t kPinCSn{29};
+
+	SPIAnalogueInputGroup(size_t axisCount = kDefaultAxisCount, uint32_t sampleRateHz = kDefaultSampleRateHz)
+	    : axisCount(axisCount <= kMaxAxisCount ? axisCount : kMaxAxisCount), sampleRateHz(sampleRateHz){};
+
+	// Call to initialise.
+	virtual void Init() override;
+
+	// Print the pin assignments over the UART.
+	void PrintDiagnostics();
+
+	// Called each frame to process the inputs.
+	// Returns true if the state has changed.
+	virtual bool OnTask() override;
+
+	// True if our state has changed this frame.
+	virtual bool HasStateChanged() override
+	{
+		return true;
+	};
+
+	// Change the rate of the sweeps. Call again if the system clock changes, the pacing timer runs from it.
+	void SetSampleRate(uint32_t newSampleRateHz);
+
+	// Full sweeps of all the axes per second.
+	uint32_t GetSampleRate() const
+	{
+		return sampleRateHz;
+	};
+
+	// Conversions the DMA has managed per second, over the last second.
+	uint32_t GetConversionRate() const
+	{
+		return measuredConversionsPerSecond;
+	};
+
+	// The number of axes in use.
+	size_t GetAxisCount() const
+	{
+		return axisCount;
+	};
+
+	// Get the raw value read from the ADC channel.
+	int16_t GetRawValue(size_t axisID) const
+	{
+		return analogueInputs[axisID].value;
+	};
+
+	// Convert the raw value to something useful to XInput.
+	int8_t GetXBox(size_t axisID) const
+	{
+		return analogueInputs[axisID].GetXBoxValue();
+	};
+
+	// Pick the response curve for an axis.
+	void SetResponseCurve(size_t axisID, ResponseCurveID curveID)
+	{
+		analogueInputs[axisID].responseCurve = GetResponseCurve(curveID);
+	};
+
+	// The command sent to convert a single-ended channel.
+	static void EncodeCommand(uint8_t channel, uint8_t *command)
+	{
+		command[0] = 0x00;
+		command[1] = 0x06 | ((channel >> 2) & 0x01); // Start bit, single-ended, D2.
+		command[2] = (channel & 0x03) << 6;          // D1, D0.
+		command[3] = 0x00;
+	};
+
+	// Pull the 12 bit result out of the bytes clocked back in.
+	static int16_t DecodeSample(const uint8_t *sample)
+	{
+		return static_cast<int16_t>(((sample[2] & 0x0F) << 8) | sample[3]);
+	};
+
+  private:
+	// Start or restart the DMA channel which paces the conversions.
+	void StartPacing();
+
+	// The number of axes in use.
+	size_t axisCount;
+
+	// Full sweeps of all the axes per second.
+	uint32_t sampleRateHz;
+
+	// Conversion slots in a sweep, rounded up to a power of two for the DMA address ring.
+	size_t slotCount{1};
+
+	// DMA resources.
+	int txChannel{-1};
+	int rxChannel{-1};
+	int pacingChannel{-1};
+	int pacingTimer{-1};
+
+	// Written to the multi-channel trigger register to start a conversion.
+	uint32_t triggerMask{0};
+
+	// For measuring the actual conversion rate.
+	uint32_t lastRateCheckTime{0};
+	uint32_t lastRateCheckCount{0};
+	uint32_t measuredConversionsPerSecond{0};
+
+	// Commands for each slot. Aligned so the DMA can ring around them.
+	alignas(kBufferSize) uint8_t commandBuffer[kBufferSize]{};
+
+	// Samples clocked back for each slot.
+	alignas(kBufferSize) volatile uint8_t sampleBuffer[kBufferSize]{};
+
+	// Private store of the decoded values. The ID of each is its ADC channel.
+	AnalogueInput analogueInputs[kMaxAxisCount]{{0}, {1}, {2}, {3}, {4}, {5}, {6}, {7}};
+};
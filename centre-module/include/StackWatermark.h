@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Tracks the deepest each core's stack has been, by painting the unused stack with a pattern and later finding how far
+// into it we have written.
+class StackWatermark
+{
+  public:
+	// The number of cores, each with their own stack.
+	const static size_t kCoreCount{2};
+
+	// Call as early as possible in main, before the stack gets deep. Core 1's stack is painted as well, so it needs to
+	// be called before core 1 is launched.
+	void Init();
+
+	// Called each frame, checks the marks once a second and prints them if they have grown.
+	void OnTask();
+
+	// Bytes of stack the core has used at most so far.
+	uint32_t GetHighWaterMark(size_t core) const;
+
+	// Total bytes of stack the core has.
+	uint32_t GetStackSize(size_t core) const;
+
+	// Dump the marks over the UART.
+	void Print() const;
+
+  private:
+	// The marks at the last check.
+	uint32_t lastHighWaterMarks[kCoreCount]{};
+
+	// When we last checked.
+	uint32_t lastCheckTime{0};
+};
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "DigitalInput.h"
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Flags kept for each switch.
+enum SwitchHealthFlags
+{
+	// The switch is pressed right now.
+	kSwitchHealthPressed = 0x01,
+
+	// Held down for longer than anyone would. Cleared when it's released.
+	kSwitchHealthStuckOn = 0x02,
+
+	// The rest of the panel has been pressed a lot more than usual since this switch last was. Cleared when it's
+	// pressed.
+	kSwitchHealthStuckOff = 0x04,
+
+	// Has been stuck on at some point since the stats were reset.
+	kSwitchHealthWasStuckOn = 0x08,
+
+	// The pin belongs to something else, such as an encoder, so the switch never changes. It isn't checked for being
+	// stuck.
+	kSwitchHealthNotInUse = 0x10,
+};
+
+
+// The statistics for a switch. The counters stop at their maximum rather than wrapping.
+struct SwitchStats
+{
+	// Presses, not counting bounces.
+	uint16_t pressCount;
+
+	// Changes of state too soon after the last one to be a person.
+	uint16_t bounceCount;
+
+	// Presses too short to be a person, but too long to be a bounce. A sign of a switch on its way out.
+	uint16_t chatterCount;
+
+	// Shortest and longest the switch has been held down.
+	uint16_t minHoldMS;
+	uint16_t maxHoldMS;
+
+	// SwitchHealthFlags.
+	uint8_t flags;
+};
+
+
+// Keeps health statistics for every switch, which can be read back over a HID feature report.
+//
+// The feature report is a page of statistics. Setting the report picks the page and can reset the stats:
+//   byte 0 - the first switch in the page.
+//   byte 1 - 0 to just pick the page, 1 to also reset all the stats.
+// Getting the report returns:
+//   byte 0 - the first switch in the page.
+//   byte 1 - the number of switches on the panel.
+//   byte 2 - the number of switches in the page.
+//   then for each switch, 12 bytes, little endian:
+//     press count (2), bounce count (2), chatter count (2), min hold ms (2), max hold ms (2), flags (1), GPIO (1).
+//   Until the switch has been pressed and released, min hold ms reads 65535 and max hold ms reads 0.
+// A full page of five switches is 63 bytes, which with the report ID fills CFG_TUD_HID_EP_BUFSIZE.
+class SwitchHealth
+{
+  public:
+	// Changes closer together than this are contact bounce.
+	const static uint32_t kBounceWindowUS{5000};
+
+	// Presses shorter than this are chatter.
+	const static uint32_t kChatterHoldUS{20000};
+
+	// Held longer than this is stuck on.
+	const static uint32_t kStuckOnUS{30000000};
+
+	// Presses of the rest of the panel, since this switch was last pressed, before we call it stuck off. Switches
+	// which usually go longer between presses get kStuckOffGapMultiple times their average gap instead, so the likes
+	// of start and the coin switch aren't flagged for being used rarely.
+	const static uint32_t kStuckOffPanelPresses{2000};
+	const static uint32_t kStuckOffGapMultiple{8};
+
+	// Presses a switch needs before its gaps say anything. One used less than this is never called stuck off.
+	const static uint16_t kStuckOffMinPresses{5};
+
+	// The bytes for each switch in the feature report.
+	const static size_t kReportBytesPerSwitch{12};
+
+	// The bytes before the first switch in the feature report.
+	const static size_t kReportHeaderBytes{3};
+
+	// Call to initialise, once the switches are set up.
+	void Init(const DigitalInputGroup *digitalInputGroup);
+
+	// Call after each scan which changed any of the switches. The work is only done for the ones which changed.
+	void OnInputsChanged(uint32_t timeUS);
+
+	// Called each frame, checks the switches in use for being stuck once a second.
+	void OnTask();
+
+	// Clear all the statistics.
+	void Reset();
+
+	// Fill in the feature report. Returns the number of bytes written.
+	uint16_t GetReport(uint8_t *buffer, uint16_t length) const;
+
+	// Handle the feature report being set.
+	void SetReport(const uint8_t *buffer, uint16_t length);
+
+	// The statistics for a switch.
+	const SwitchStats &GetStats(size_t input) const
+	{
+		return switchStats[input];
+	};
+
+  private:
+	// Timing we need to keep, but don't report.
+	struct SwitchTracking
+	{
+		uint32_t lastChangeUS;
+		uint32_t pressStartUS;
+		uint32_t panelPressesAtLastPress;
+	};
+
+	// Called for a switch which has changed state.
+	void OnChange(size_t input, bool isPressed, uint32_t timeUS);
+
+	// Where the switches come from.
+	const DigitalInputGroup *digitalInputGroup{nullptr};
+
+	// The number of switches on the panel.
+	size_t inputCount{0};
+
+	// The first switch in the feature report.
+	size_t reportFirstInput{0};
+
+	// Presses of any switch, not counting bounces.
+	uint32_t panelPressCount{0};
+
+	// When we last checked for stuck switches.
+	uint32_t lastCheckTime{0};
+
+	SwitchStats switchStats[DigitalInputGroup::kMaxInputCount]{};
+	SwitchTracking switchTracking[DigitalInputGroup::kMaxInputCount]{};
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "tusb.h"
+
+
+// TinyUSB made the HID report lengths 16 bit in 0.14. The callbacks have to match its declarations exactly, or in C++
+// they're taken as new functions and TinyUSB goes on calling its own empty ones.
+#if TUSB_VERSION_MAJOR == 0 && TUSB_VERSION_MINOR < 14
+typedef uint8_t HIDReportLength;
+#else
+typedef uint16_t HIDReportLength;
+#endif
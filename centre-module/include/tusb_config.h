@@ -1,6 +1,8 @@
 #ifndef _TUSB_CONFIG_H_
 #define _TUSB_CONFIG_H_
 
+#include "PanelLayout.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -71,14 +73,16 @@ extern "C" {
 #endif
 
 //------------- CLASS -------------//
-#define CFG_TUD_HID               1
+// One HID instance for each player's gamepad
+#define CFG_TUD_HID               PANEL_PLAYER_COUNT
 #define CFG_TUD_CDC               0
 #define CFG_TUD_MSC               0
 #define CFG_TUD_MIDI              0
 #define CFG_TUD_VENDOR            0
 
 // HID buffer size Should be sufficient to hold ID (if any) + Data
-#define CFG_TUD_HID_EP_BUFSIZE    16
+// This also sizes GET/SET_REPORT on the control endpoint, so it's big enough for the diagnostic feature reports
+#define CFG_TUD_HID_EP_BUFSIZE    64
 
 #ifdef __cplusplus
 }
@@ -1,13 +1,32 @@
 #ifndef USB_DESCRIPTORS_H_
 #define USB_DESCRIPTORS_H_
 
+// Hosts and tools keep hold of the report IDs, so every one is given its value and new ones go on the end.
 enum
 {
+	// Input reports, sent in turn by the report chain.
 	REPORT_ID_KEYBOARD = 1,
-	REPORT_ID_MOUSE,
-	REPORT_ID_CONSUMER_CONTROL,
-	REPORT_ID_GAMEPAD,
-	REPORT_ID_COUNT
+	REPORT_ID_MOUSE = 2,
+	REPORT_ID_CONSUMER_CONTROL = 3,
+	REPORT_ID_GAMEPAD = 4,
+
+	// Feature reports, read and written by the host over the control endpoint.
+	REPORT_ID_SWITCH_HEALTH = 5,
+	REPORT_ID_INPUT_HISTORY = 6,
+
+	// The latency probe, written by the host and echoed back as an input report after the chain. See
+	// SendLatencyProbeEcho().
+	REPORT_ID_LATENCY_PROBE = 7
 };
 
+// The report chain runs from the keyboard through to this one.
+#define REPORT_ID_LAST_CHAINED REPORT_ID_GAMEPAD
+
+// Feature reports all fill the control buffer, less the report ID.
+#define FEATURE_REPORT_SIZE (CFG_TUD_HID_EP_BUFSIZE - 1)
+
+// The latency probe from the host, and the echo we send back. See LatencyProbe.h.
+#define LATENCY_PROBE_SIZE 8
+#define LATENCY_PROBE_ECHO_SIZE 24
+
 #endif
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "HIDBackend.h"
+
+
+// Writes the reports to stdout as hex, for when there's no /dev/uhid or you just want to see them.
+class DumpBackend : public HIDBackend
+{
+  public:
+	virtual bool Open() override;
+	virtual void Close() override;
+	virtual void OnTask() override;
+	virtual bool IsStarted() const override;
+	virtual bool SendReport(uint8_t instance, const uint8_t *report, uint16_t length) override;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+
+// Where the simulated device's HID traffic goes. There is one HID interface for each TinyUSB HID instance.
+class HIDBackend
+{
+  public:
+	virtual ~HIDBackend() = default;
+
+	// Create the device, with an interface for each HID instance. Returns false if it couldn't be.
+	virtual bool Open() = 0;
+
+	// Remove the device.
+	virtual void Close() = 0;
+
+	// Called from tud_task to handle anything the host has sent.
+	virtual void OnTask() = 0;
+
+	// True once the host is ready to take reports.
+	virtual bool IsStarted() const = 0;
+
+	// Send an IN report. For numbered reports, the first byte is the report ID.
+	virtual bool SendReport(uint8_t instance, const uint8_t *report, uint16_t length) = 0;
+
+	// Print anything the backend has measured, when the simulation finishes.
+	virtual void PrintStats() const {};
+};
+
+
+// Helpers for backends, which read the device's own descriptors the way a host would.
+namespace HIDDescriptors
+{
+// The length of an instance's HID report descriptor, from the configuration descriptor.
+uint16_t GetReportDescriptorLength(uint8_t instance);
+
+// The product name, from the string descriptor.
+void GetProductName(char *name, uint16_t nameSize);
+} // namespace HIDDescriptors
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "pico/types.h"
+
+
+// Models the quadrature encoder program running on pio0's state machines, so a test decides when each one goes round
+// its loop. Each time round it samples the pins, steps its count by the entry in the program's jump table for the
+// previous and current AB states, and pushes the count without blocking. The RX FIFO is joined, so it holds 8 counts
+// and drops any more.
+namespace HostPIO
+{
+// What a jump table entry does to the count.
+enum Transition
+{
+	kTransitionNone = 0,
+	kTransitionIncrement = 1,
+	kTransitionDecrement = -1,
+};
+
+// The number of entries in the jump table, one for each pair of AB states.
+const size_t kTransitionCount{16};
+
+// Read the jump table from the program source. Returns false if it isn't one we understand.
+bool LoadProgram(const char *path);
+
+// The loaded jump table entry for moving from one AB state to another.
+Transition GetTransition(uint previousAB, uint currentAB);
+
+// Set the A and B pins for a state machine's encoder, A in bit 0, and run the program round once.
+void SetPins(uint sm, uint ab);
+
+// Run the program round without the pins changing.
+void RunLoop(uint sm);
+
+// Free the state machines. The program stays loaded.
+void Reset();
+} // namespace HostPIO
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "MCP3208Model.h"
+#include "pico/types.h"
+
+
+// Drives the stand-ins for the SPI and DMA hardware, so a test decides when each transfer happens. Only spi1 has
+// anything on its bus. Its hardware chip select goes low when the first byte is clocked and high again when the TX
+// FIFO runs dry, as it does in SPI mode 3.
+namespace HostSPI
+{
+// Put a device on spi1, behind its chip select.
+void Attach(MCP3208Model *device);
+
+// Fire a DMA timer, giving each busy channel paced by it one transfer.
+void TickTimer(uint timer);
+
+// The rate a DMA timer fires at, from the system clock and the fraction it was given.
+uint32_t GetTimerRate(uint timer);
+
+// Clock one byte through spi1 if a DMA channel has one waiting to go, and let the RX channels take what comes back.
+// Returns false if there was nothing to send, releasing chip select.
+bool ClockByte();
+
+// Clock bytes through until there are none waiting. Returns how many went.
+size_t ClockAll();
+
+// Free every channel and timer and take the device off the bus, ready for the next test.
+void Reset();
+} // namespace HostSPI
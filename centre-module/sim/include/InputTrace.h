@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+
+// A script of switch and axis changes, played back through the GPIO and ADC stand-ins.
+//
+// One event per line, with the time in milliseconds from the start of the trace, or from the last event with a '+':
+//   <ms> press <switch>
+//   <ms> release <switch>
+//   <ms> axis <axis> <0-4095>
+//   <ms> end
+// The switch is the name from the layout in DigitalInput.cpp (e.g. "B1") or "gpio <n>". Blank lines and anything after
+// a '#' are ignored. When the trace is repeated, each pass starts at the 'end', or at the last event if there isn't one.
+class InputTrace
+{
+  public:
+	// The ADC reading for a centred stick.
+	const static uint16_t kAxisCentre{2048};
+
+	// The most axes a trace can move.
+	const static size_t kMaxAxisCount{4};
+
+	// Read a trace from a file. Returns false, having printed why, if it couldn't be read.
+	bool Load(const char *path);
+
+	// Play the trace this many times over.
+	void SetRepeatCount(uint32_t count)
+	{
+		repeatCount = count;
+	};
+
+	// Start playing the trace from this time.
+	void Start(uint32_t timeUS);
+
+	// True once Start has been called.
+	bool IsStarted() const
+	{
+		return isStarted;
+	};
+
+	// True once every event has been played.
+	bool IsFinished() const
+	{
+		return isStarted && repeatsPlayed == repeatCount;
+	};
+
+	// When the last event was played.
+	uint32_t GetLastEventTime() const
+	{
+		return lastEventTime;
+	};
+
+	// The state of all the GPIO pins as of this time. The switches pull low when pressed.
+	uint32_t GetGPIOState(uint32_t timeUS);
+
+	// The ADC reading for an axis as of this time.
+	uint16_t GetAxisValue(size_t axis, uint32_t timeUS);
+
+	// Call when a report has been sent, to time it against the events since the last one.
+	void OnReportSent(uint32_t timeUS);
+
+	// Print how many events were played and how long they took to be reported.
+	void PrintStats(uint32_t timeUS) const;
+
+  private:
+	enum EventType
+	{
+		kEventPress,
+		kEventRelease,
+		kEventAxis,
+	};
+
+	struct Event
+	{
+		// From the start of the trace.
+		uint32_t timeUS;
+
+		EventType type;
+
+		// GPIO for switches, axis number for the axes.
+		uint32_t target;
+
+		// Only used by the axes.
+		uint16_t value;
+	};
+
+	// Apply every event that's due by this time.
+	void Play(uint32_t timeUS);
+
+	// Turn a switch name into its GPIO. Returns false if there's no such switch.
+	static bool FindSwitch(const char *name, uint32_t &gpio);
+
+	std::vector<Event> events;
+
+	// How long one pass of the trace lasts.
+	uint32_t traceLength{0};
+
+	// Playback position.
+	bool isStarted{false};
+	uint32_t startTime{0};
+	size_t nextEvent{0};
+	uint32_t repeatCount{1};
+	uint32_t repeatsPlayed{0};
+	uint32_t lastEventTime{0};
+
+	// The state the events have built up.
+	uint32_t gpioState{0xFFFFFFFF};
+	uint16_t axisValues[kMaxAxisCount]{kAxisCentre, kAxisCentre, kAxisCentre, kAxisCentre};
+
+	// When the earliest event not yet covered by a report was due, for timing the latency.
+	bool hasUnreportedEvent{false};
+	uint32_t unreportedEventTime{0};
+
+	// Statistics.
+	uint32_t eventsPlayed{0};
+	uint32_t reportsSent{0};
+	uint32_t firstReportTime{0};
+	std::vector<uint32_t> latencies;
+};
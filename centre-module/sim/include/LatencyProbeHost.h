@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+
+// The host's side of the latency probe. Makes the probes, matches up the echoes and keeps the times. It doesn't mind
+// how the reports get to and from the device, so it's shared by the tool and the simulation.
+class LatencyProbeHost
+{
+  public:
+	// Give up on an echo after this long.
+	const static uint32_t kEchoTimeoutUS{100000};
+
+	// Write the next probe into the buffer, report ID first. Returns its length.
+	uint16_t MakeProbe(uint8_t *buffer, uint32_t hostTimeUS);
+
+	// Pass on each IN report as it arrives. Returns true if it was the echo we were waiting for.
+	bool OnReport(const uint8_t *report, uint16_t length, uint32_t hostTimeUS);
+
+	// True while waiting for an echo. Once the timeout has passed it's counted as lost.
+	bool IsWaiting(uint32_t hostTimeUS);
+
+	// The number of echoes which have come back.
+	uint32_t GetEchoCount() const
+	{
+		return static_cast<uint32_t>(roundTrips.size());
+	};
+
+	// Print the times.
+	void Print() const;
+
+  private:
+	static void PrintDistribution(const char *name, const std::vector<uint32_t> &times);
+
+	// The probe in flight.
+	uint32_t nextSequence{1};
+	bool isWaiting{false};
+	uint32_t waitingSequence{0};
+	uint32_t sentTime{0};
+
+	// The device's count of scan-to-report times at the last echo, so each one is only taken once.
+	bool hasScanToReportCount{false};
+	uint32_t lastScanToReportCount{0};
+
+	uint32_t lostCount{0};
+
+	// Probe sent to echo received, on the host's clock.
+	std::vector<uint32_t> roundTrips;
+
+	// Probe received to echo sent, on the device's clock.
+	std::vector<uint32_t> firmwareTimes;
+
+	// What's left of the round trip, spent in USB and the host's stack.
+	std::vector<uint32_t> transportTimes;
+
+	// Switch change on the scan to the report going out, on the device's clock.
+	std::vector<uint32_t> scanToReportTimes;
+};
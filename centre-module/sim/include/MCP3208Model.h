@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+// A bit level model of an MCP3208 (8 channel, 12 bit ADC), for checking the commands we send it and how we pick the
+// results out of what comes back. It follows the serial timing in the datasheet: once chip select is low, the first
+// high bit clocked in is the start bit. SGL/DIFF and D2-D0 follow it, then a clock to sample, a null bit and B11-B0
+// MSB first. If the clock keeps going it sends B1-B11 again LSB first, then zeros.
+//
+// DOUT is high impedance until the null bit. Here it reads as 1, so anything which doesn't mask those bits off shows
+// up in the results.
+class MCP3208Model
+{
+  public:
+	// The number of input channels.
+	const static size_t kChannelCount{8};
+
+	// Full scale.
+	const static uint16_t kMaxValue{4095};
+
+	// Set the voltage on an input, as the code it converts to. Clamped to full scale.
+	void SetValue(uint8_t channel, uint16_t value);
+
+	// Chip select going low and high. Either one abandons a conversion part way through.
+	void Select();
+	void Deselect();
+
+	bool IsSelected() const
+	{
+		return isSelected;
+	};
+
+	// Clock a byte through, MSB first. Returns the byte clocked out at the same time.
+	uint8_t Transfer(uint8_t mosi);
+
+	// Conversions started since the model was created.
+	uint32_t GetConversionCount() const
+	{
+		return conversionCount;
+	};
+
+	// The channel and mode of the last conversion.
+	uint8_t GetLastChannel() const
+	{
+		return lastChannel;
+	};
+	bool WasLastSingleEnded() const
+	{
+		return wasLastSingleEnded;
+	};
+
+  private:
+	// One clock, with DIN as the master set it. Returns DOUT as the master samples it.
+	bool Clock(bool din);
+
+	// Each input, as the code it converts to.
+	uint16_t values[kChannelCount]{};
+
+	bool isSelected{false};
+
+	// Clocks since the start bit, or -1 while we're still waiting for one.
+	int clocksSinceStart{-1};
+
+	// SGL/DIFF, D2, D1 and D0 as they are clocked in.
+	uint8_t command{0};
+
+	// The result being clocked out.
+	uint16_t result{0};
+
+	uint32_t conversionCount{0};
+	uint8_t lastChannel{0};
+	bool wasLastSingleEnded{false};
+};
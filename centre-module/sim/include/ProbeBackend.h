@@ -0,0 +1,37 @@
+#pragma once
+
+#include "HIDBackend.h"
+#include "LatencyProbeHost.h"
+#include "tusb.h"
+
+
+// Stands in for the host and uhid, sending latency probes straight into the firmware's callbacks and taking the echoes
+// from its reports. The USB stack isn't there, so the round trip is the firmware and the simulated polling only.
+class ProbeBackend : public HIDBackend
+{
+  public:
+	// Time between probes.
+	void SetInterval(uint32_t intervalUS)
+	{
+		probeIntervalUS = intervalUS;
+	};
+
+	virtual bool Open() override;
+	virtual void Close() override;
+	virtual void OnTask() override;
+	virtual bool IsStarted() const override;
+	virtual bool SendReport(uint8_t instance, const uint8_t *report, uint16_t length) override;
+	virtual void PrintStats() const override;
+
+  private:
+	LatencyProbeHost probe;
+
+	uint32_t probeIntervalUS{50000};
+	uint32_t lastProbeTime{0};
+
+	// The echo, held until the host would have polled for it.
+	bool hasEcho{false};
+	uint32_t echoSentTime{0};
+	uint16_t echoLength{0};
+	uint8_t echo[CFG_TUD_HID_EP_BUFSIZE];
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "HIDBackend.h"
+#include "InputTrace.h"
+#include <signal.h>
+#include <stdint.h>
+
+
+// Everything the stand-ins for the SDK and TinyUSB share.
+struct Simulation
+{
+	// Where the reports go.
+	HIDBackend *backend{nullptr};
+
+	// Where the inputs come from.
+	InputTrace *trace{nullptr};
+
+	// How often the host polls the IN endpoints. Matches the interval in the configuration descriptor.
+	uint32_t pollIntervalUS{5000};
+
+	// Time for the host to find the device before the trace starts.
+	uint32_t startDelayUS{1000000};
+
+	// Time to keep running after the trace has finished, so the last reports get out.
+	uint32_t lingerUS{500000};
+
+	// Set by the signal handlers, to finish at the next task.
+	volatile sig_atomic_t isStopRequested{0};
+};
+
+extern Simulation g_simulation;
+
+// Print the stats and shut everything down.
+[[noreturn]] void ExitSimulation(int status);
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "HIDBackend.h"
+#include "tusb.h"
+
+struct uhid_event;
+
+
+// Presents the device to the kernel through /dev/uhid, so it shows up to evdev and hidraw like the real thing.
+class UHIDBackend : public HIDBackend
+{
+  public:
+	virtual bool Open() override;
+	virtual void Close() override;
+	virtual void OnTask() override;
+	virtual bool IsStarted() const override;
+	virtual bool SendReport(uint8_t instance, const uint8_t *report, uint16_t length) override;
+
+  private:
+	// Handle a single event from the kernel.
+	void OnEvent(uint8_t instance, const struct uhid_event &event);
+
+	// Reply to the kernel asking for a report.
+	void OnGetReport(uint8_t instance, const struct uhid_event &event);
+
+	// Reply to the kernel setting a report.
+	void OnSetReport(uint8_t instance, const struct uhid_event &event);
+
+	// Pass a report from the host on to the firmware, as TinyUSB would.
+	void SetReport(uint8_t instance, uint8_t reportID, hid_report_type_t type, const uint8_t *data, uint16_t length);
+
+	// One uhid device for each HID instance.
+	int uhidFiles[CFG_TUD_HID]{};
+
+	// Which instances the kernel has started.
+	bool isInstanceStarted[CFG_TUD_HID]{};
+
+	// True once all the instances have started.
+	bool isStarted{false};
+};
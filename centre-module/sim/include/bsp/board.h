@@ -0,0 +1,21 @@
+#ifndef _SIM_BSP_BOARD_H
+#define _SIM_BSP_BOARD_H
+
+// Host stand-in for TinyUSB's board support. There's no LED, so it's written to nowhere.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void board_init(void);
+void board_led_write(bool state);
+uint32_t board_millis(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
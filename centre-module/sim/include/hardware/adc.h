@@ -0,0 +1,21 @@
+#ifndef _SIM_HARDWARE_ADC_H
+#define _SIM_HARDWARE_ADC_H
+
+// Host stand-in for the Pico SDK's ADC functions. The axes read back whatever the input trace says.
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+uint16_t adc_read(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
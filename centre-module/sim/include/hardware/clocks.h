@@ -0,0 +1,42 @@
+#ifndef _SIM_HARDWARE_CLOCKS_H
+#define _SIM_HARDWARE_CLOCKS_H
+
+// Host stand-in for the Pico SDK's clock functions. Changing the clock has no effect on the host.
+
+#include "pico/types.h"
+
+#define KHZ 1000
+#define MHZ 1000000
+
+enum clock_index
+{
+	clk_gpout0 = 0,
+	clk_gpout1,
+	clk_gpout2,
+	clk_gpout3,
+	clk_ref,
+	clk_sys,
+	clk_peri,
+	clk_usb,
+	clk_adc,
+	clk_rtc,
+	CLK_COUNT
+};
+
+#define CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS 0x0
+#define CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS 0x1
+#define CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB 0x2
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool clock_configure(enum clock_index clk_index, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq);
+uint32_t clock_get_hz(enum clock_index clk_index);
+bool set_sys_clock_khz(uint32_t freq_khz, bool required);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
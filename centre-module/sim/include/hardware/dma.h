@@ -0,0 +1,72 @@
+#ifndef _SIM_HARDWARE_DMA_H
+#define _SIM_HARDWARE_DMA_H
+
+// Host stand-in for the Pico SDK's DMA functions. Channels move data when the test says their DREQ has fired, see
+// HostSPI.h. The addresses are pointer sized, since the buffers they point at live in a 64 bit process.
+
+#include "pico/types.h"
+
+#define NUM_DMA_CHANNELS 12
+#define NUM_DMA_TIMERS 4
+
+enum dma_channel_transfer_size
+{
+	DMA_SIZE_8 = 0,
+	DMA_SIZE_16 = 1,
+	DMA_SIZE_32 = 2
+};
+
+// Timer DREQs come after the peripheral ones, as they do on the RP2040.
+#define DREQ_DMA_TIMER0 59
+
+typedef struct
+{
+	enum dma_channel_transfer_size dataSize;
+	bool isReadIncrement;
+	bool isWriteIncrement;
+	bool isRingOnWrite;
+	uint ringSizeBits;
+	uint dreq;
+} dma_channel_config;
+
+typedef struct
+{
+	volatile uintptr_t read_addr;
+	volatile uintptr_t write_addr;
+	volatile uint32_t transfer_count;
+} dma_channel_hw_t;
+
+typedef struct
+{
+	dma_channel_hw_t ch[NUM_DMA_CHANNELS];
+	volatile uint32_t multi_channel_trigger;
+} dma_hw_t;
+
+extern dma_hw_t *const dma_hw;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int dma_claim_unused_channel(bool required);
+int dma_claim_unused_timer(bool required);
+
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config *config, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *config, bool incr);
+void channel_config_set_write_increment(dma_channel_config *config, bool incr);
+void channel_config_set_ring(dma_channel_config *config, bool write, uint size_bits);
+void channel_config_set_dreq(dma_channel_config *config, uint dreq);
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+    const volatile void *read_addr, uint transfer_count, bool trigger);
+bool dma_channel_is_busy(uint channel);
+
+void dma_timer_set_fraction(uint timer, uint16_t numerator, uint16_t denominator);
+uint dma_get_timer_dreq(uint timer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef _SIM_HARDWARE_GPIO_H
+#define _SIM_HARDWARE_GPIO_H
+
+// Host stand-in for the Pico SDK's GPIO functions. The pins read back whatever the input trace says.
+
+#include "pico/types.h"
+
+enum gpio_function
+{
+	GPIO_FUNC_SPI = 1,
+	GPIO_FUNC_UART = 2,
+	GPIO_FUNC_SIO = 5,
+	GPIO_FUNC_PIO0 = 6,
+	GPIO_FUNC_PIO1 = 7,
+	GPIO_FUNC_NULL = 0x1f,
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void gpio_init(uint gpio);
+void gpio_init_mask(uint gpio_mask);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_set_dir_in_masked(uint32_t mask);
+void gpio_pull_up(uint gpio);
+void gpio_put(uint gpio, bool value);
+uint32_t gpio_get_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
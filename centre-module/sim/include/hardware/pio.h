@@ -0,0 +1,38 @@
+#ifndef _SIM_HARDWARE_PIO_H
+#define _SIM_HARDWARE_PIO_H
+
+// Host stand-in for the Pico SDK's PIO functions. Programs aren't run, the state machines are models driven by the
+// test, see HostPIO.h.
+
+#include "pico/types.h"
+
+#define NUM_PIO_STATE_MACHINES 4
+
+typedef struct pio_hw pio_hw_t;
+typedef pio_hw_t *PIO;
+
+extern PIO const pio0;
+extern PIO const pio1;
+
+typedef struct
+{
+	const uint16_t *instructions;
+	uint8_t length;
+	int8_t origin;
+} pio_program_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint pio_add_program(PIO pio, const pio_program_t *program);
+int pio_claim_unused_sm(PIO pio, bool required);
+uint pio_sm_get_rx_fifo_level(PIO pio, uint sm);
+uint32_t pio_sm_get(PIO pio, uint sm);
+uint32_t pio_sm_get_blocking(PIO pio, uint sm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
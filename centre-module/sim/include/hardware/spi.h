@@ -0,0 +1,50 @@
+#ifndef _SIM_HARDWARE_SPI_H
+#define _SIM_HARDWARE_SPI_H
+
+// Host stand-in for the Pico SDK's SPI functions. Bytes are clocked through whatever device the test attaches, see
+// HostSPI.h.
+
+#include "pico/types.h"
+
+typedef enum
+{
+	SPI_CPHA_0 = 0,
+	SPI_CPHA_1 = 1
+} spi_cpha_t;
+
+typedef enum
+{
+	SPI_CPOL_0 = 0,
+	SPI_CPOL_1 = 1
+} spi_cpol_t;
+
+typedef enum
+{
+	SPI_LSB_FIRST = 0,
+	SPI_MSB_FIRST = 1
+} spi_order_t;
+
+typedef struct
+{
+	volatile uint32_t dr;
+} spi_hw_t;
+
+typedef struct spi_inst spi_inst_t;
+
+extern spi_inst_t *const spi0;
+extern spi_inst_t *const spi1;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint spi_init(spi_inst_t *spi, uint baudrate);
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order);
+spi_hw_t *spi_get_hw(spi_inst_t *spi);
+uint spi_get_dreq(spi_inst_t *spi, bool is_tx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
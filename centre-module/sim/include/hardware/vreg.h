@@ -0,0 +1,32 @@
+#ifndef _SIM_HARDWARE_VREG_H
+#define _SIM_HARDWARE_VREG_H
+
+// Host stand-in for the Pico SDK's voltage regulator functions.
+
+#include "pico/types.h"
+
+enum vreg_voltage
+{
+	VREG_VOLTAGE_0_85 = 0b0110,
+	VREG_VOLTAGE_0_90 = 0b0111,
+	VREG_VOLTAGE_0_95 = 0b1000,
+	VREG_VOLTAGE_1_00 = 0b1001,
+	VREG_VOLTAGE_1_05 = 0b1010,
+	VREG_VOLTAGE_1_10 = 0b1011,
+	VREG_VOLTAGE_1_15 = 0b1100,
+	VREG_VOLTAGE_1_20 = 0b1101,
+	VREG_VOLTAGE_1_25 = 0b1110,
+	VREG_VOLTAGE_1_30 = 0b1111,
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void vreg_set_voltage(enum vreg_voltage voltage);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef _SIM_PICO_STDLIB_H
+#define _SIM_PICO_STDLIB_H
+
+// Host stand-in for the Pico SDK's standard library, just the parts the centre module uses.
+
+#include "hardware/gpio.h"
+#include "pico/time.h"
+#include "pico/types.h"
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Output goes to stdout, so there's nothing to set up.
+bool stdio_init_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef _SIM_PICO_TIME_H
+#define _SIM_PICO_TIME_H
+
+// Host stand-in for the Pico SDK's timer functions. Time starts when the simulation does.
+
+#include "pico/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef _SIM_PICO_TYPES_H
+#define _SIM_PICO_TYPES_H
+
+// Host stand-in for the Pico SDK's types.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef _SIM_QUADRATURE_ENCODER_PIO_H
+#define _SIM_QUADRATURE_ENCODER_PIO_H
+
+// Host stand-in for the header pioasm generates from quadrature_encoder.pio. The state machines are modelled by
+// HostPIO, from the jump table in the program source.
+
+#include "hardware/pio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const pio_program_t quadrature_encoder_program;
+
+void quadrature_encoder_program_init(PIO pio, uint sm, uint pin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
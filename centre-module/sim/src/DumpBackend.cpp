@@ -0,0 +1,39 @@
+#include "DumpBackend.h"
+
+#include "pico/time.h"
+#include "tusb.h"
+#include <stdio.h>
+
+
+bool DumpBackend::Open()
+{
+	for (uint8_t instance = 0; instance < CFG_TUD_HID; instance++)
+	{
+		printf("HID %u: %u byte report descriptor.\n", instance, HIDDescriptors::GetReportDescriptorLength(instance));
+	}
+
+	return true;
+}
+
+
+void DumpBackend::Close() {}
+
+
+void DumpBackend::OnTask() {}
+
+
+bool DumpBackend::IsStarted() const
+{
+	return true;
+}
+
+
+bool DumpBackend::SendReport(uint8_t instance, const uint8_t *report, uint16_t length)
+{
+	printf("HID %u IN %10u:", instance, time_us_32());
+	for (uint16_t i = 0; i < length; i++)
+		printf(" %02x", report[i]);
+	printf("\n");
+
+	return true;
+}
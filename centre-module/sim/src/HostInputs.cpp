@@ -0,0 +1,29 @@
+#include "Simulation.h"
+
+#include "hardware/adc.h"
+#include "hardware/gpio.h"
+#include "pico/time.h"
+
+
+// The stand-ins for the SDK functions which read the inputs. They come from the trace being played.
+
+// The ADC input the next read comes from.
+static uint g_adcInput = 0;
+
+
+uint32_t gpio_get_all(void)
+{
+	return g_simulation.trace->GetGPIOState(time_us_32());
+}
+
+
+void adc_select_input(uint input)
+{
+	g_adcInput = input;
+}
+
+
+uint16_t adc_read(void)
+{
+	return g_simulation.trace->GetAxisValue(g_adcInput, time_us_32());
+}
@@ -0,0 +1,241 @@
+#include "HostPIO.h"
+
+#include "hardware/pio.h"
+#include "quadrature_encoder.pio.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// The joined RX FIFO's depth.
+const size_t kRXFIFODepth{8};
+
+// The longest line we'll read from the program source.
+const size_t kMaxLineLength{256};
+
+// The most instructions a PIO can hold.
+const size_t kMaxInstructionCount{32};
+
+struct pio_hw
+{
+	int unused;
+};
+
+static pio_hw g_pio0;
+static pio_hw g_pio1;
+PIO const pio0 = &g_pio0;
+PIO const pio1 = &g_pio1;
+
+const pio_program_t quadrature_encoder_program{nullptr, 0, 0};
+
+struct StateMachine
+{
+	bool isClaimed;
+
+	// The pins as the encoder has them, A in bit 0.
+	uint pins;
+
+	// The AB state from the last time round, kept in the OSR.
+	uint previousAB;
+
+	// The count, kept in Y.
+	uint32_t y;
+
+	uint32_t rxFIFO[kRXFIFODepth];
+	size_t rxFIFOCount;
+};
+
+static StateMachine g_stateMachines[NUM_PIO_STATE_MACHINES];
+
+static HostPIO::Transition g_transitions[HostPIO::kTransitionCount];
+
+
+// Strip the comment and any surrounding spaces, in place.
+static char *TrimLine(char *line)
+{
+	char *comment = strchr(line, ';');
+	if (comment)
+		*comment = '\0';
+
+	while (isspace(static_cast<unsigned char>(*line)))
+		line++;
+
+	char *end = line + strlen(line);
+	while (end > line && isspace(static_cast<unsigned char>(end[-1])))
+		end--;
+	*end = '\0';
+
+	return line;
+}
+
+
+bool HostPIO::LoadProgram(const char *path)
+{
+	FILE *file = fopen(path, "r");
+	if (!file)
+	{
+		printf("Couldn't open '%s'.\n", path);
+		return false;
+	}
+
+	// The labels at each address, and where each jump goes.
+	char labels[kMaxInstructionCount][32]{};
+	char jumpTargets[kMaxInstructionCount][32]{};
+	size_t address = 0;
+
+	char line[kMaxLineLength];
+	while (fgets(line, sizeof(line), file) && address < kMaxInstructionCount)
+	{
+		char *text = TrimLine(line);
+
+		// The C SDK block ends the program.
+		if (text[0] == '%')
+			break;
+
+		if (text[0] == '\0' || text[0] == '.')
+			continue;
+
+		const size_t length = strlen(text);
+		if (text[length - 1] == ':')
+		{
+			text[length - 1] = '\0';
+			if (strncmp(text, "public ", 7) == 0)
+				text += 7;
+			snprintf(labels[address], sizeof(labels[address]), "%s", text);
+			continue;
+		}
+
+		// Only an unconditional jump counts, anything else runs on to the next label.
+		char target[32];
+		if (sscanf(text, "jmp %31s", target) == 1 && strchr(text, ',') == nullptr)
+			snprintf(jumpTargets[address], sizeof(jumpTargets[address]), "%s", target);
+
+		address++;
+	}
+
+	fclose(file);
+
+	bool isLoaded = true;
+	for (size_t i = 0; i < kTransitionCount; i++)
+	{
+		const char *target = jumpTargets[i][0] ? jumpTargets[i] : labels[i];
+
+		if (strcmp(target, "update") == 0)
+			g_transitions[i] = kTransitionNone;
+		else if (strcmp(target, "increment") == 0)
+			g_transitions[i] = kTransitionIncrement;
+		else if (strcmp(target, "decrement") == 0)
+			g_transitions[i] = kTransitionDecrement;
+		else
+		{
+			printf("Jump table entry %zu goes to '%s'.\n", i, target);
+			isLoaded = false;
+		}
+	}
+
+	return isLoaded;
+}
+
+
+HostPIO::Transition HostPIO::GetTransition(uint previousAB, uint currentAB)
+{
+	return g_transitions[((previousAB & 3) << 2) | (currentAB & 3)];
+}
+
+
+void HostPIO::SetPins(uint sm, uint ab)
+{
+	g_stateMachines[sm].pins = ab & 3;
+	RunLoop(sm);
+}
+
+
+void HostPIO::RunLoop(uint sm)
+{
+	StateMachine &stateMachine = g_stateMachines[sm];
+
+	stateMachine.y += GetTransition(stateMachine.previousAB, stateMachine.pins);
+	stateMachine.previousAB = stateMachine.pins;
+
+	// push noblock
+	if (stateMachine.rxFIFOCount < kRXFIFODepth)
+		stateMachine.rxFIFO[stateMachine.rxFIFOCount++] = stateMachine.y;
+}
+
+
+void HostPIO::Reset()
+{
+	memset(g_stateMachines, 0, sizeof(g_stateMachines));
+}
+
+
+uint pio_add_program(PIO pio, const pio_program_t *program)
+{
+	(void)pio;
+	(void)program;
+	return 0;
+}
+
+
+int pio_claim_unused_sm(PIO pio, bool required)
+{
+	(void)pio;
+	(void)required;
+
+	for (uint sm = 0; sm < NUM_PIO_STATE_MACHINES; sm++)
+	{
+		if (!g_stateMachines[sm].isClaimed)
+		{
+			g_stateMachines[sm].isClaimed = true;
+			return sm;
+		}
+	}
+
+	return -1;
+}
+
+
+uint pio_sm_get_rx_fifo_level(PIO pio, uint sm)
+{
+	(void)pio;
+	return g_stateMachines[sm].rxFIFOCount;
+}
+
+
+uint32_t pio_sm_get(PIO pio, uint sm)
+{
+	(void)pio;
+
+	// Reading an empty FIFO gets nothing useful.
+	StateMachine &stateMachine = g_stateMachines[sm];
+	if (stateMachine.rxFIFOCount == 0)
+		return 0;
+
+	const uint32_t value = stateMachine.rxFIFO[0];
+	memmove(stateMachine.rxFIFO, stateMachine.rxFIFO + 1, --stateMachine.rxFIFOCount * sizeof(uint32_t));
+	return value;
+}
+
+
+uint32_t pio_sm_get_blocking(PIO pio, uint sm)
+{
+	// The program pushes every time round, so we only wait for one loop.
+	if (g_stateMachines[sm].rxFIFOCount == 0)
+		HostPIO::RunLoop(sm);
+
+	return pio_sm_get(pio, sm);
+}
+
+
+void quadrature_encoder_program_init(PIO pio, uint sm, uint pin)
+{
+	(void)pio;
+	(void)pin;
+
+	// The count starts at zero and the previous state is seeded from the pins, which are pulled up.
+	StateMachine &stateMachine = g_stateMachines[sm];
+	stateMachine.pins = 3;
+	stateMachine.previousAB = stateMachine.pins;
+	stateMachine.y = 0;
+	stateMachine.rxFIFOCount = 0;
+}
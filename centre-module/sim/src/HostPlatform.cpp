@@ -0,0 +1,155 @@
+#include "bsp/board.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/gpio.h"
+#include "hardware/vreg.h"
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include <time.h>
+
+
+// The system clock the firmware thinks it's running at.
+static uint32_t g_sysClockKHz = 125000;
+
+
+static uint64_t GetMonotonicUS()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
+
+uint64_t time_us_64(void)
+{
+	// Time starts at zero, like it does on the Pico.
+	static const uint64_t startTime = GetMonotonicUS();
+	return GetMonotonicUS() - startTime;
+}
+
+
+uint32_t time_us_32(void)
+{
+	return static_cast<uint32_t>(time_us_64());
+}
+
+
+void sleep_us(uint64_t us)
+{
+	struct timespec duration;
+	duration.tv_sec = us / 1000000;
+	duration.tv_nsec = (us % 1000000) * 1000;
+	nanosleep(&duration, nullptr);
+}
+
+
+void sleep_ms(uint32_t ms)
+{
+	sleep_us(static_cast<uint64_t>(ms) * 1000);
+}
+
+
+bool stdio_init_all(void)
+{
+	return true;
+}
+
+
+void gpio_init(uint gpio)
+{
+	(void)gpio;
+}
+
+
+void gpio_init_mask(uint gpio_mask)
+{
+	(void)gpio_mask;
+}
+
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+	(void)gpio;
+	(void)fn;
+}
+
+
+void gpio_set_dir(uint gpio, bool out)
+{
+	(void)gpio;
+	(void)out;
+}
+
+
+void gpio_set_dir_in_masked(uint32_t mask)
+{
+	(void)mask;
+}
+
+
+void gpio_pull_up(uint gpio)
+{
+	(void)gpio;
+}
+
+
+void gpio_put(uint gpio, bool value)
+{
+	(void)gpio;
+	(void)value;
+}
+
+
+void adc_init(void) {}
+
+
+void adc_gpio_init(uint gpio)
+{
+	(void)gpio;
+}
+
+
+bool clock_configure(enum clock_index clk_index, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq)
+{
+	(void)clk_index;
+	(void)src;
+	(void)auxsrc;
+	(void)src_freq;
+	(void)freq;
+	return true;
+}
+
+
+uint32_t clock_get_hz(enum clock_index clk_index)
+{
+	return clk_index == clk_sys ? g_sysClockKHz * KHZ : 48 * MHZ;
+}
+
+
+bool set_sys_clock_khz(uint32_t freq_khz, bool required)
+{
+	(void)required;
+	g_sysClockKHz = freq_khz;
+	return true;
+}
+
+
+void vreg_set_voltage(enum vreg_voltage voltage)
+{
+	(void)voltage;
+}
+
+
+void board_init(void) {}
+
+
+void board_led_write(bool state)
+{
+	(void)state;
+}
+
+
+uint32_t board_millis(void)
+{
+	return static_cast<uint32_t>(time_us_64() / 1000);
+}
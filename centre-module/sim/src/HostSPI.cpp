@@ -0,0 +1,373 @@
+#include "HostSPI.h"
+
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/spi.h"
+#include <string.h>
+
+
+// The SPI DREQs, as numbered on the RP2040.
+enum
+{
+	dreqSPI0TX = 16,
+	dreqSPI0RX = 17,
+	dreqSPI1TX = 18,
+	dreqSPI1RX = 19,
+};
+
+// The depth of the SPI's RX FIFO. Anything clocked in while it's full is lost.
+const size_t kRXFIFODepth{8};
+
+struct spi_inst
+{
+	spi_hw_t hw;
+};
+
+static spi_inst g_spi0;
+static spi_inst g_spi1;
+spi_inst_t *const spi0 = &g_spi0;
+spi_inst_t *const spi1 = &g_spi1;
+
+static dma_hw_t g_dmaHW;
+dma_hw_t *const dma_hw = &g_dmaHW;
+
+// What the registers don't show.
+struct DMAChannelState
+{
+	bool isClaimed;
+	bool isBusy;
+	dma_channel_config config;
+
+	// TRANS_COUNT is reloaded from this each time the channel is triggered.
+	uint32_t reloadCount;
+};
+
+struct DMATimerState
+{
+	bool isClaimed;
+	uint16_t numerator;
+	uint16_t denominator;
+};
+
+static DMAChannelState g_dmaChannels[NUM_DMA_CHANNELS];
+static DMATimerState g_dmaTimers[NUM_DMA_TIMERS];
+
+static MCP3208Model *g_spiDevice = nullptr;
+
+static uint8_t g_rxFIFO[kRXFIFODepth];
+static size_t g_rxFIFOCount = 0;
+
+
+static uint TransferSize(const dma_channel_config &config)
+{
+	return 1U << config.dataSize;
+}
+
+
+// Move an address on by one transfer, keeping it inside its ring if it has one.
+static uintptr_t AdvanceAddress(uintptr_t address, uint size, uint ringSizeBits)
+{
+	if (ringSizeBits == 0)
+		return address + size;
+
+	const uintptr_t ringMask = (static_cast<uintptr_t>(1) << ringSizeBits) - 1;
+	return (address & ~ringMask) | ((address + size) & ringMask);
+}
+
+
+static void TriggerChannels(uint32_t mask)
+{
+	for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+	{
+		if (mask & (1U << channel))
+		{
+			dma_hw->ch[channel].transfer_count = g_dmaChannels[channel].reloadCount;
+			g_dmaChannels[channel].isBusy = g_dmaChannels[channel].reloadCount > 0;
+		}
+	}
+}
+
+
+// Reads and writes the DMA makes, with the registers which do something when they're touched.
+static uint32_t ReadBus(uintptr_t address, uint size)
+{
+	if (address == reinterpret_cast<uintptr_t>(&spi1->hw.dr))
+	{
+		const uint32_t value = g_rxFIFOCount > 0 ? g_rxFIFO[0] : 0;
+		if (g_rxFIFOCount > 0)
+			memmove(g_rxFIFO, g_rxFIFO + 1, --g_rxFIFOCount);
+		return value;
+	}
+
+	uint32_t value = 0;
+	memcpy(&value, reinterpret_cast<const void *>(address), size);
+	return value;
+}
+
+
+static void WriteBus(uintptr_t address, uint32_t value, uint size)
+{
+	if (address == reinterpret_cast<uintptr_t>(&dma_hw->multi_channel_trigger))
+	{
+		TriggerChannels(value);
+		return;
+	}
+
+	if (address == reinterpret_cast<uintptr_t>(&spi1->hw.dr))
+	{
+		if (g_spiDevice && !g_spiDevice->IsSelected())
+			g_spiDevice->Select();
+
+		// With nothing on the bus, MISO is pulled high.
+		const uint8_t miso = g_spiDevice ? g_spiDevice->Transfer(static_cast<uint8_t>(value)) : 0xFF;
+		if (g_rxFIFOCount < kRXFIFODepth)
+			g_rxFIFO[g_rxFIFOCount++] = miso;
+		return;
+	}
+
+	memcpy(reinterpret_cast<void *>(address), &value, size);
+}
+
+
+static void TransferOnce(uint channel)
+{
+	DMAChannelState &state = g_dmaChannels[channel];
+	dma_channel_hw_t &hw = dma_hw->ch[channel];
+	const uint size = TransferSize(state.config);
+
+	WriteBus(hw.write_addr, ReadBus(hw.read_addr, size), size);
+
+	if (state.config.isReadIncrement)
+		hw.read_addr = AdvanceAddress(hw.read_addr, size, state.config.isRingOnWrite ? 0 : state.config.ringSizeBits);
+	if (state.config.isWriteIncrement)
+		hw.write_addr = AdvanceAddress(hw.write_addr, size, state.config.isRingOnWrite ? state.config.ringSizeBits : 0);
+
+	hw.transfer_count = hw.transfer_count - 1;
+	state.isBusy = hw.transfer_count > 0;
+}
+
+
+// The first busy channel waiting on a DREQ, or -1.
+static int FindBusyChannel(uint dreq)
+{
+	for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+	{
+		if (g_dmaChannels[channel].isBusy && g_dmaChannels[channel].config.dreq == dreq)
+			return channel;
+	}
+
+	return -1;
+}
+
+
+int dma_claim_unused_channel(bool required)
+{
+	(void)required;
+
+	for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+	{
+		if (!g_dmaChannels[channel].isClaimed)
+		{
+			g_dmaChannels[channel].isClaimed = true;
+			return channel;
+		}
+	}
+
+	return -1;
+}
+
+
+int dma_claim_unused_timer(bool required)
+{
+	(void)required;
+
+	for (uint timer = 0; timer < NUM_DMA_TIMERS; timer++)
+	{
+		if (!g_dmaTimers[timer].isClaimed)
+		{
+			g_dmaTimers[timer].isClaimed = true;
+			return timer;
+		}
+	}
+
+	return -1;
+}
+
+
+dma_channel_config dma_channel_get_default_config(uint channel)
+{
+	(void)channel;
+
+	dma_channel_config config{};
+	config.dataSize = DMA_SIZE_32;
+	config.isReadIncrement = true;
+	config.isWriteIncrement = false;
+	config.dreq = 0x3F; // Unpaced.
+	return config;
+}
+
+
+void channel_config_set_transfer_data_size(dma_channel_config *config, enum dma_channel_transfer_size size)
+{
+	config->dataSize = size;
+}
+
+
+void channel_config_set_read_increment(dma_channel_config *config, bool incr)
+{
+	config->isReadIncrement = incr;
+}
+
+
+void channel_config_set_write_increment(dma_channel_config *config, bool incr)
+{
+	config->isWriteIncrement = incr;
+}
+
+
+void channel_config_set_ring(dma_channel_config *config, bool write, uint size_bits)
+{
+	config->isRingOnWrite = write;
+	config->ringSizeBits = size_bits;
+}
+
+
+void channel_config_set_dreq(dma_channel_config *config, uint dreq)
+{
+	config->dreq = dreq;
+}
+
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+    const volatile void *read_addr, uint transfer_count, bool trigger)
+{
+	g_dmaChannels[channel].config = *config;
+	g_dmaChannels[channel].reloadCount = transfer_count;
+	g_dmaChannels[channel].isBusy = false;
+
+	dma_hw->ch[channel].write_addr = reinterpret_cast<uintptr_t>(write_addr);
+	dma_hw->ch[channel].read_addr = reinterpret_cast<uintptr_t>(read_addr);
+	dma_hw->ch[channel].transfer_count = transfer_count;
+
+	if (trigger)
+		TriggerChannels(1U << channel);
+}
+
+
+bool dma_channel_is_busy(uint channel)
+{
+	return g_dmaChannels[channel].isBusy;
+}
+
+
+void dma_timer_set_fraction(uint timer, uint16_t numerator, uint16_t denominator)
+{
+	g_dmaTimers[timer].numerator = numerator;
+	g_dmaTimers[timer].denominator = denominator;
+}
+
+
+uint dma_get_timer_dreq(uint timer)
+{
+	return DREQ_DMA_TIMER0 + timer;
+}
+
+
+uint spi_init(spi_inst_t *spi, uint baudrate)
+{
+	(void)spi;
+	return baudrate;
+}
+
+
+void spi_set_format(spi_inst_t *spi, uint data_bits, spi_cpol_t cpol, spi_cpha_t cpha, spi_order_t order)
+{
+	(void)spi;
+	(void)data_bits;
+	(void)cpol;
+	(void)cpha;
+	(void)order;
+}
+
+
+spi_hw_t *spi_get_hw(spi_inst_t *spi)
+{
+	return &spi->hw;
+}
+
+
+uint spi_get_dreq(spi_inst_t *spi, bool is_tx)
+{
+	if (spi == spi0)
+		return is_tx ? dreqSPI0TX : dreqSPI0RX;
+
+	return is_tx ? dreqSPI1TX : dreqSPI1RX;
+}
+
+
+void HostSPI::Attach(MCP3208Model *device)
+{
+	g_spiDevice = device;
+}
+
+
+void HostSPI::TickTimer(uint timer)
+{
+	for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+	{
+		if (g_dmaChannels[channel].isBusy && g_dmaChannels[channel].config.dreq == dma_get_timer_dreq(timer))
+			TransferOnce(channel);
+	}
+}
+
+
+uint32_t HostSPI::GetTimerRate(uint timer)
+{
+	const DMATimerState &state = g_dmaTimers[timer];
+	if (state.denominator == 0)
+		return 0;
+
+	return static_cast<uint32_t>(static_cast<uint64_t>(clock_get_hz(clk_sys)) * state.numerator / state.denominator);
+}
+
+
+bool HostSPI::ClockByte()
+{
+	const int txChannel = FindBusyChannel(dreqSPI1TX);
+	if (txChannel < 0)
+	{
+		// The TX FIFO has run dry, so the hardware chip select goes back up.
+		if (g_spiDevice && g_spiDevice->IsSelected())
+			g_spiDevice->Deselect();
+		return false;
+	}
+
+	TransferOnce(txChannel);
+
+	// Let the RX channels empty the FIFO.
+	for (int rxChannel = FindBusyChannel(dreqSPI1RX); rxChannel >= 0 && g_rxFIFOCount > 0;
+	     rxChannel = FindBusyChannel(dreqSPI1RX))
+		TransferOnce(rxChannel);
+
+	return true;
+}
+
+
+size_t HostSPI::ClockAll()
+{
+	size_t count = 0;
+	while (ClockByte())
+		count++;
+
+	return count;
+}
+
+
+void HostSPI::Reset()
+{
+	memset(g_dmaChannels, 0, sizeof(g_dmaChannels));
+	memset(g_dmaTimers, 0, sizeof(g_dmaTimers));
+	memset(&g_dmaHW, 0, sizeof(g_dmaHW));
+	g_rxFIFOCount = 0;
+	g_spiDevice = nullptr;
+}
@@ -0,0 +1,192 @@
+#include "Simulation.h"
+
+#include "TinyUSBCompat.h"
+#include "pico/time.h"
+#include "tusb.h"
+#include "usb_descriptors.h"
+#include <string.h>
+
+
+// The descriptor types we look for in the configuration.
+static const uint8_t kDescriptorTypeInterface{0x04};
+static const uint8_t kDescriptorTypeHID{0x21};
+
+// The language we ask for the strings in.
+static const uint16_t kLanguageEnglishUS{0x0409};
+
+
+// An IN endpoint, which holds a report until the host polls for it.
+struct HostEndpoint
+{
+	bool isBusy;
+	uint32_t sentTime;
+	uint16_t length;
+	uint8_t report[CFG_TUD_HID_EP_BUFSIZE];
+};
+
+static HostEndpoint g_endpoints[CFG_TUD_HID];
+static bool g_isMounted = false;
+static uint32_t g_mountTime = 0;
+
+
+bool tusb_init(void)
+{
+	return true;
+}
+
+
+bool tud_mounted(void)
+{
+	return g_isMounted;
+}
+
+
+bool tud_suspended(void)
+{
+	return false;
+}
+
+
+bool tud_remote_wakeup(void)
+{
+	return false;
+}
+
+
+// Stands in for the USB interrupt and TinyUSB's event queue. TinyUSB made tud_task a wrapper in 0.14. The host's requests come in here, and the endpoints
+// complete once the host has had time to poll them.
+#if TUSB_VERSION_MAJOR == 0 && TUSB_VERSION_MINOR < 14
+void tud_task(void)
+#else
+void tud_task_ext(uint32_t timeout_ms, bool in_isr)
+#endif
+{
+#if !(TUSB_VERSION_MAJOR == 0 && TUSB_VERSION_MINOR < 14)
+	(void)timeout_ms;
+	(void)in_isr;
+#endif
+
+	g_simulation.backend->OnTask();
+	const uint32_t currentTime = time_us_32();
+
+	// Follow the host picking the device up, and letting it go.
+	if (!g_isMounted && g_simulation.backend->IsStarted())
+	{
+		g_isMounted = true;
+		g_mountTime = currentTime;
+		tud_mount_cb();
+	}
+	else if (g_isMounted && !g_simulation.backend->IsStarted())
+	{
+		g_isMounted = false;
+		tud_umount_cb();
+	}
+
+	// Give the host a moment to find us before the inputs start.
+	InputTrace &trace = *g_simulation.trace;
+	if (g_isMounted && !trace.IsStarted() && currentTime - g_mountTime >= g_simulation.startDelayUS)
+		trace.Start(currentTime);
+
+	for (uint8_t instance = 0; instance < CFG_TUD_HID; instance++)
+	{
+		HostEndpoint &endpoint = g_endpoints[instance];
+		if (endpoint.isBusy && currentTime - endpoint.sentTime >= g_simulation.pollIntervalUS)
+		{
+			endpoint.isBusy = false;
+			tud_hid_report_complete_cb(instance, endpoint.report, static_cast<HIDReportLength>(endpoint.length));
+		}
+	}
+
+	if (g_simulation.isStopRequested)
+		ExitSimulation(1);
+
+	if (trace.IsFinished() && currentTime - trace.GetLastEventTime() >= g_simulation.lingerUS)
+		ExitSimulation(0);
+}
+
+
+bool tud_hid_n_ready(uint8_t instance)
+{
+	return g_isMounted && !g_endpoints[instance].isBusy;
+}
+
+
+bool tud_hid_n_report(uint8_t instance, uint8_t report_id, void const *report, HIDReportLength len)
+{
+	if (!tud_hid_n_ready(instance))
+		return false;
+
+	HostEndpoint &endpoint = g_endpoints[instance];
+
+	// Numbered reports lead with their ID, the same as TinyUSB.
+	uint16_t length = 0;
+	if (report_id)
+		endpoint.report[length++] = report_id;
+
+	const uint16_t dataLength = TU_MIN(static_cast<uint16_t>(len), CFG_TUD_HID_EP_BUFSIZE - length);
+	memcpy(endpoint.report + length, report, dataLength);
+	length += dataLength;
+
+	if (!g_simulation.backend->SendReport(instance, endpoint.report, length))
+		return false;
+
+	endpoint.isBusy = true;
+	endpoint.sentTime = time_us_32();
+	endpoint.length = length;
+
+	// The probe echoes don't carry any inputs.
+	if (report_id != REPORT_ID_LATENCY_PROBE)
+		g_simulation.trace->OnReportSent(endpoint.sentTime);
+
+	return true;
+}
+
+
+bool tud_hid_n_mouse_report(
+    uint8_t instance, uint8_t report_id, uint8_t buttons, int8_t x, int8_t y, int8_t vertical, int8_t horizontal)
+{
+	hid_mouse_report_t report{};
+	report.buttons = buttons;
+	report.x = x;
+	report.y = y;
+	report.wheel = vertical;
+	report.pan = horizontal;
+
+	return tud_hid_n_report(instance, report_id, &report, sizeof(report));
+}
+
+
+uint16_t HIDDescriptors::GetReportDescriptorLength(uint8_t instance)
+{
+	const uint8_t *configuration = tud_descriptor_configuration_cb(0);
+	const uint16_t totalLength = configuration[2] | (configuration[3] << 8);
+
+	// Walk the descriptors the way the host does. Each HID interface is the next instance along.
+	int hidInstance = -1;
+	for (uint16_t offset = 0; offset < totalLength; offset += configuration[offset])
+	{
+		const uint8_t *descriptor = configuration + offset;
+
+		if (descriptor[1] == kDescriptorTypeInterface)
+			hidInstance++;
+		else if (descriptor[1] == kDescriptorTypeHID && hidInstance == instance)
+			return descriptor[7] | (descriptor[8] << 8);
+	}
+
+	return 0;
+}
+
+
+void HIDDescriptors::GetProductName(char *name, uint16_t nameSize)
+{
+	const tusb_desc_device_t *device = reinterpret_cast<const tusb_desc_device_t *>(tud_descriptor_device_cb());
+
+	// The first character holds the length in bytes, including itself.
+	const uint16_t *product = tud_descriptor_string_cb(device->iProduct, kLanguageEnglishUS);
+	const size_t charCount = product ? ((product[0] & 0xFF) / 2) - 1 : 0;
+
+	size_t i = 0;
+	for (; i < charCount && i + 1 < nameSize; i++)
+		name[i] = static_cast<char>(product[i + 1]);
+	name[i] = '\0';
+}
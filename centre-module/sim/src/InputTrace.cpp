@@ -0,0 +1,248 @@
+#include "InputTrace.h"
+
+#include "DigitalInput.h"
+#include <algorithm>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+
+// The longest line we'll read from a trace.
+static const size_t kMaxLineLength{256};
+
+
+// Strip leading and trailing spaces, in place.
+static char *Trim(char *text)
+{
+	while (isspace(static_cast<unsigned char>(*text)))
+		text++;
+
+	char *end = text + strlen(text);
+	while (end > text && isspace(static_cast<unsigned char>(end[-1])))
+		end--;
+	*end = '\0';
+
+	return text;
+}
+
+
+bool InputTrace::FindSwitch(const char *name, uint32_t &gpio)
+{
+	if (strncasecmp(name, "gpio ", 5) == 0)
+	{
+		gpio = strtoul(name + 5, nullptr, 10);
+		return gpio < 32;
+	}
+
+	// The layout is a table in DigitalInput.cpp, which doesn't need the group to be initialised.
+	const DigitalInputGroup layout;
+	for (size_t i = 0; i < layout.GetInputCount(); i++)
+	{
+		if (strcasecmp(name, layout.GetInputName(i)) == 0)
+		{
+			gpio = layout.GetInputGPIO(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+bool InputTrace::Load(const char *path)
+{
+	FILE *file = fopen(path, "r");
+	if (!file)
+	{
+		printf("Trace: can't open %s.\n", path);
+		return false;
+	}
+
+	events.clear();
+	traceLength = 0;
+
+	uint32_t previousTime = 0;
+	bool hasEnd = false;
+	char line[kMaxLineLength];
+	for (size_t lineNumber = 1; fgets(line, sizeof(line), file); lineNumber++)
+	{
+		char *comment = strchr(line, '#');
+		if (comment)
+			*comment = '\0';
+
+		char *text = Trim(line);
+		if (!*text)
+			continue;
+
+		// Times are absolute, or relative to the last event with a '+'.
+		const bool isRelative = *text == '+';
+		char *end;
+		const uint32_t timeMS = strtoul(text + (isRelative ? 1 : 0), &end, 10);
+		if (end == text)
+		{
+			printf("Trace: %s:%u: expected a time.\n", path, lineNumber);
+			fclose(file);
+			return false;
+		}
+
+		Event event{};
+		event.timeUS = (isRelative ? previousTime : 0) + timeMS * 1000;
+		previousTime = event.timeUS;
+
+		text = Trim(end);
+		char *arguments = text;
+		while (*arguments && !isspace(static_cast<unsigned char>(*arguments)))
+			arguments++;
+		if (*arguments)
+			*arguments++ = '\0';
+		arguments = Trim(arguments);
+
+		bool isValid = true;
+		if (strcasecmp(text, "press") == 0 || strcasecmp(text, "release") == 0)
+		{
+			event.type = strcasecmp(text, "press") == 0 ? kEventPress : kEventRelease;
+			isValid = FindSwitch(arguments, event.target);
+		}
+		else if (strcasecmp(text, "axis") == 0)
+		{
+			unsigned axis, value;
+			event.type = kEventAxis;
+			isValid = sscanf(arguments, "%u %u", &axis, &value) == 2 && axis < kMaxAxisCount && value < 4096;
+			event.target = axis;
+			event.value = static_cast<uint16_t>(value);
+		}
+		else if (strcasecmp(text, "end") == 0)
+		{
+			traceLength = event.timeUS;
+			hasEnd = true;
+			continue;
+		}
+		else
+		{
+			isValid = false;
+		}
+
+		if (!isValid)
+		{
+			printf("Trace: %s:%u: can't make sense of '%s %s'.\n", path, lineNumber, text, arguments);
+			fclose(file);
+			return false;
+		}
+
+		events.push_back(event);
+	}
+
+	fclose(file);
+
+	// Play them in time order, however they were written.
+	std::stable_sort(
+	    events.begin(), events.end(), [](const Event &a, const Event &b) { return a.timeUS < b.timeUS; });
+
+	if (!hasEnd && !events.empty())
+		traceLength = events.back().timeUS;
+
+	printf("Trace: %u events over %u ms.\n", events.size(), traceLength / 1000);
+
+	return true;
+}
+
+
+void InputTrace::Start(uint32_t timeUS)
+{
+	isStarted = true;
+	startTime = timeUS;
+	nextEvent = 0;
+	repeatsPlayed = events.empty() ? repeatCount : 0;
+	lastEventTime = timeUS;
+}
+
+
+void InputTrace::Play(uint32_t timeUS)
+{
+	if (!isStarted)
+		return;
+
+	// The next pass can start in the future, so compare the difference as signed.
+	while (repeatsPlayed < repeatCount && static_cast<int32_t>(timeUS - startTime - events[nextEvent].timeUS) >= 0)
+	{
+		const Event &event = events[nextEvent];
+		switch (event.type)
+		{
+			case kEventPress: gpioState &= ~(1U << event.target); break;
+			case kEventRelease: gpioState |= (1U << event.target); break;
+			case kEventAxis: axisValues[event.target] = event.value; break;
+		}
+
+		// Latency is timed from when the event was due, not when we got round to it.
+		if (!hasUnreportedEvent)
+		{
+			hasUnreportedEvent = true;
+			unreportedEventTime = startTime + event.timeUS;
+		}
+
+		eventsPlayed++;
+		lastEventTime = timeUS;
+
+		if (++nextEvent == events.size())
+		{
+			nextEvent = 0;
+			repeatsPlayed++;
+			startTime += traceLength;
+		}
+	}
+}
+
+
+uint32_t InputTrace::GetGPIOState(uint32_t timeUS)
+{
+	Play(timeUS);
+	return gpioState;
+}
+
+
+uint16_t InputTrace::GetAxisValue(size_t axis, uint32_t timeUS)
+{
+	Play(timeUS);
+	return axis < kMaxAxisCount ? axisValues[axis] : kAxisCentre;
+}
+
+
+void InputTrace::OnReportSent(uint32_t timeUS)
+{
+	if (!isStarted)
+		return;
+
+	if (reportsSent++ == 0)
+		firstReportTime = timeUS;
+
+	if (hasUnreportedEvent)
+	{
+		latencies.push_back(timeUS - unreportedEventTime);
+		hasUnreportedEvent = false;
+	}
+}
+
+
+void InputTrace::PrintStats(uint32_t timeUS) const
+{
+	printf("Trace: %u events played, %u reports sent", eventsPlayed, reportsSent);
+	if (reportsSent > 1)
+		printf(", %.1f reports/s", (reportsSent - 1) * 1e6 / (timeUS - firstReportTime));
+	printf(".\n");
+
+	if (latencies.empty())
+		return;
+
+	std::vector<uint32_t> sorted(latencies);
+	std::sort(sorted.begin(), sorted.end());
+
+	uint64_t total = 0;
+	for (uint32_t latency : sorted)
+		total += latency;
+
+	printf("Trace: event to report latency, us: min %u, median %u, p99 %u, max %u, mean %u.\n", sorted.front(),
+	       sorted[sorted.size() / 2], sorted[(sorted.size() * 99) / 100], sorted.back(),
+	       static_cast<uint32_t>(total / sorted.size()));
+}
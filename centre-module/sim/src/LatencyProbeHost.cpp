@@ -0,0 +1,96 @@
+#include "LatencyProbeHost.h"
+
+#include "LatencyProbe.h"
+#include "usb_descriptors.h"
+#include <algorithm>
+#include <stdio.h>
+
+
+uint16_t LatencyProbeHost::MakeProbe(uint8_t *buffer, uint32_t hostTimeUS)
+{
+	buffer[0] = REPORT_ID_LATENCY_PROBE;
+	LatencyProbe::EncodeProbe(buffer + 1, nextSequence, hostTimeUS);
+
+	isWaiting = true;
+	waitingSequence = nextSequence++;
+	sentTime = hostTimeUS;
+
+	return 1 + LatencyProbe::kProbeBytes;
+}
+
+
+bool LatencyProbeHost::OnReport(const uint8_t *report, uint16_t length, uint32_t hostTimeUS)
+{
+	if (length < 1 + LatencyProbe::kEchoBytes || report[0] != REPORT_ID_LATENCY_PROBE)
+		return false;
+
+	LatencyProbeEcho echo;
+	LatencyProbe::DecodeEcho(report + 1, echo);
+
+	// Late echoes for probes we've given up on don't count.
+	if (!isWaiting || echo.sequence != waitingSequence)
+		return false;
+
+	isWaiting = false;
+
+	// The two clocks can't be compared, only the times measured on each.
+	const uint32_t roundTrip = hostTimeUS - echo.hostTime;
+	const uint32_t firmwareTime = echo.sendTimeUS - echo.receiveTimeUS;
+	roundTrips.push_back(roundTrip);
+	firmwareTimes.push_back(firmwareTime);
+	transportTimes.push_back(roundTrip > firmwareTime ? roundTrip - firmwareTime : 0);
+
+	if (echo.scanToReportCount != 0 && (!hasScanToReportCount || echo.scanToReportCount != lastScanToReportCount))
+		scanToReportTimes.push_back(echo.scanToReportUS);
+	hasScanToReportCount = true;
+	lastScanToReportCount = echo.scanToReportCount;
+
+	return true;
+}
+
+
+bool LatencyProbeHost::IsWaiting(uint32_t hostTimeUS)
+{
+	if (isWaiting && hostTimeUS - sentTime >= kEchoTimeoutUS)
+	{
+		isWaiting = false;
+		lostCount++;
+	}
+
+	return isWaiting;
+}
+
+
+void LatencyProbeHost::PrintDistribution(const char *name, const std::vector<uint32_t> &times)
+{
+	if (times.empty())
+	{
+		printf("%-22s no samples\n", name);
+		return;
+	}
+
+	std::vector<uint32_t> sorted(times);
+	std::sort(sorted.begin(), sorted.end());
+
+	uint64_t total = 0;
+	for (uint32_t time : sorted)
+		total += time;
+
+	printf("%-22s %6u %8u %8u %8u %8u %8u %8u\n", name, sorted.size(), sorted.front(), sorted[sorted.size() / 2],
+	       sorted[(sorted.size() * 9) / 10], sorted[(sorted.size() * 99) / 100], sorted.back(),
+	       static_cast<uint32_t>(total / sorted.size()));
+}
+
+
+void LatencyProbeHost::Print() const
+{
+	printf("Latency probe: %u echoes, %u lost. Times in us.\n", GetEchoCount(), lostCount);
+	printf("%-22s %6s %8s %8s %8s %8s %8s %8s\n", "", "count", "min", "median", "p90", "p99", "max", "mean");
+
+	// The round trip on the host's clock, split into the device's part of it and the rest. Then the time inside the
+	// firmware from a switch changing to it being reported, which the round trip doesn't see.
+	PrintDistribution("USB round trip", roundTrips);
+	PrintDistribution("  USB and host", transportTimes);
+	PrintDistribution("  Firmware turnaround", firmwareTimes);
+	PrintDistribution("Scan to report", scanToReportTimes);
+}
@@ -0,0 +1,118 @@
+#include "LatencyProbeHost.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/hidraw.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <time.h>
+#include <unistd.h>
+
+
+// Sends latency probes to a centre module, or the simulation, through hidraw and prints how long the echoes took.
+
+
+// The biggest report the device sends.
+static const size_t kMaxReportSize{64};
+
+
+static uint32_t GetTimeUS()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return static_cast<uint32_t>(static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000);
+}
+
+
+static void PrintUsage(const char *program)
+{
+	printf("Usage: %s [options] /dev/hidrawN\n", program);
+	printf("  --count <n>        Probes to send (default 1000).\n");
+	printf("  --interval-ms <ms> Time between probes (default 50).\n");
+	printf("  --output           Send the probes as output reports rather than feature reports.\n");
+}
+
+
+int main(int argc, char **argv)
+{
+	uint32_t count = 1000;
+	uint32_t intervalMS = 50;
+	bool useOutputReport = false;
+	const char *path = nullptr;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const bool hasValue = i + 1 < argc;
+
+		if (strcmp(argv[i], "--count") == 0 && hasValue)
+			count = strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--interval-ms") == 0 && hasValue)
+			intervalMS = strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--output") == 0)
+			useOutputReport = true;
+		else if (argv[i][0] != '-' && !path)
+			path = argv[i];
+		else
+		{
+			PrintUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (!path)
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	const int file = open(path, O_RDWR | O_CLOEXEC);
+	if (file < 0)
+	{
+		printf("Can't open %s: %s\n", path, strerror(errno));
+		return 1;
+	}
+
+	LatencyProbeHost probe;
+	uint8_t report[kMaxReportSize];
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const uint32_t probeTime = GetTimeUS();
+		const uint16_t probeLength = probe.MakeProbe(report, probeTime);
+
+		const int result = useOutputReport ? write(file, report, probeLength)
+		                                   : ioctl(file, HIDIOCSFEATURE(probeLength), report);
+		if (result < 0)
+		{
+			printf("Can't send the probe: %s\n", strerror(errno));
+			close(file);
+			return 1;
+		}
+
+		// The gamepad reports keep coming, so pick the echo out from amongst them.
+		while (probe.IsWaiting(GetTimeUS()))
+		{
+			struct pollfd pollFile = {file, POLLIN, 0};
+			if (poll(&pollFile, 1, 1) <= 0)
+				continue;
+
+			const ssize_t length = read(file, report, sizeof(report));
+			const uint32_t receiveTime = GetTimeUS();
+			if (length > 0)
+				probe.OnReport(report, static_cast<uint16_t>(length), receiveTime);
+		}
+
+		// Keep to the interval, however long the echo took.
+		const uint32_t elapsedUS = GetTimeUS() - probeTime;
+		if (elapsedUS < intervalMS * 1000)
+			usleep(intervalMS * 1000 - elapsedUS);
+	}
+
+	close(file);
+	probe.Print();
+
+	return 0;
+}
@@ -0,0 +1,104 @@
+#include "MCP3208Model.h"
+
+
+// Clocks from the start bit to each part of the conversion.
+enum
+{
+	clockLastCommandBit = 4,
+	clockNullBit = 6,
+	clockMSB = 7,
+	clockLSB = clockMSB + 11,
+	clockLastLSBFirst = clockLSB + 11,
+};
+
+
+void MCP3208Model::SetValue(uint8_t channel, uint16_t value)
+{
+	values[channel % kChannelCount] = value > kMaxValue ? kMaxValue : value;
+}
+
+
+void MCP3208Model::Select()
+{
+	isSelected = true;
+	clocksSinceStart = -1;
+}
+
+
+void MCP3208Model::Deselect()
+{
+	isSelected = false;
+	clocksSinceStart = -1;
+}
+
+
+uint8_t MCP3208Model::Transfer(uint8_t mosi)
+{
+	uint8_t miso = 0;
+	for (int bit = 7; bit >= 0; bit--)
+	{
+		if (Clock((mosi >> bit) & 1))
+			miso |= 1 << bit;
+	}
+
+	return miso;
+}
+
+
+bool MCP3208Model::Clock(bool din)
+{
+	// Nothing happens without chip select, and DOUT stays high impedance.
+	if (!isSelected)
+		return true;
+
+	if (clocksSinceStart < 0)
+	{
+		// Leading zeros are ignored.
+		if (din)
+		{
+			clocksSinceStart = 0;
+			command = 0;
+		}
+		return true;
+	}
+
+	clocksSinceStart++;
+
+	if (clocksSinceStart <= clockLastCommandBit)
+	{
+		command = (command << 1) | (din ? 1 : 0);
+
+		// Sample once we know the channel.
+		if (clocksSinceStart == clockLastCommandBit)
+		{
+			const bool isSingleEnded = command & 0x08;
+			const uint8_t channel = command & 0x07;
+
+			if (isSingleEnded)
+				result = values[channel];
+			else
+			{
+				// Pairs of inputs, D0 picks which one is IN+.
+				const uint16_t positive = values[channel];
+				const uint16_t negative = values[channel ^ 1];
+				result = positive > negative ? positive - negative : 0;
+			}
+
+			conversionCount++;
+			lastChannel = channel;
+			wasLastSingleEnded = isSingleEnded;
+		}
+		return true;
+	}
+
+	if (clocksSinceStart < clockNullBit)
+		return true;
+	if (clocksSinceStart == clockNullBit)
+		return false;
+	if (clocksSinceStart <= clockLSB)
+		return (result >> (clockLSB - clocksSinceStart)) & 1;
+	if (clocksSinceStart <= clockLastLSBFirst)
+		return (result >> (clocksSinceStart - clockLSB)) & 1;
+
+	return false;
+}
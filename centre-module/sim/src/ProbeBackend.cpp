@@ -0,0 +1,68 @@
+#include "ProbeBackend.h"
+
+#include "LatencyProbe.h"
+#include "Simulation.h"
+#include "pico/time.h"
+#include "tusb.h"
+#include "usb_descriptors.h"
+#include <stdio.h>
+#include <string.h>
+
+
+bool ProbeBackend::Open()
+{
+	printf("Probe: sending a latency probe every %u ms.\n", probeIntervalUS / 1000);
+	return true;
+}
+
+
+void ProbeBackend::Close() {}
+
+
+void ProbeBackend::OnTask()
+{
+	const uint32_t currentTime = time_us_32();
+
+	// The host sees the echo when it next polls the endpoint.
+	if (hasEcho && currentTime - echoSentTime >= g_simulation.pollIntervalUS)
+	{
+		probe.OnReport(echo, echoLength, currentTime);
+		hasEcho = false;
+	}
+
+	if (probe.IsWaiting(currentTime) || currentTime - lastProbeTime < probeIntervalUS)
+		return;
+
+	uint8_t report[1 + LatencyProbe::kProbeBytes];
+	const uint16_t length = probe.MakeProbe(report, currentTime);
+	lastProbeTime = currentTime;
+
+	// TinyUSB strips the report ID before passing it on.
+	tud_hid_set_report_cb(0, report[0], HID_REPORT_TYPE_FEATURE, report + 1, length - 1);
+}
+
+
+bool ProbeBackend::IsStarted() const
+{
+	return true;
+}
+
+
+bool ProbeBackend::SendReport(uint8_t instance, const uint8_t *report, uint16_t length)
+{
+	if (instance == 0 && length > 0 && report[0] == REPORT_ID_LATENCY_PROBE && length <= sizeof(echo))
+	{
+		memcpy(echo, report, length);
+		echoLength = length;
+		echoSentTime = time_us_32();
+		hasEcho = true;
+	}
+
+	return true;
+}
+
+
+void ProbeBackend::PrintStats() const
+{
+	probe.Print();
+}
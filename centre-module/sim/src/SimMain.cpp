@@ -0,0 +1,110 @@
+#include "DumpBackend.h"
+#include "InputTrace.h"
+#include "ProbeBackend.h"
+#include "Simulation.h"
+#include "UHIDBackend.h"
+
+#include "pico/time.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// The firmware's main, renamed by the build.
+int CentreModuleMain(void);
+
+Simulation g_simulation;
+
+static InputTrace g_trace;
+static UHIDBackend g_uhidBackend;
+static DumpBackend g_dumpBackend;
+static ProbeBackend g_probeBackend;
+
+
+static void PrintUsage(const char *program)
+{
+	printf("Usage: %s [options] <trace>\n", program);
+	printf("  --dump            Print the reports instead of creating a uhid device.\n");
+	printf("  --probe           Send latency probes straight to the firmware instead of creating a uhid device.\n");
+	printf("  --probe-interval-ms <ms>  Time between the probes (default 50).\n");
+	printf("  --repeat <n>      Play the trace n times over.\n");
+	printf("  --poll-us <us>    How often the host polls for reports (default %u).\n", g_simulation.pollIntervalUS);
+	printf("  --delay-ms <ms>   Time for the host to find the device before the trace starts (default %u).\n",
+	       g_simulation.startDelayUS / 1000);
+	printf("  --linger-ms <ms>  Time to keep running after the trace has finished (default %u).\n",
+	       g_simulation.lingerUS / 1000);
+}
+
+
+void ExitSimulation(int status)
+{
+	if (g_simulation.trace->IsStarted())
+		g_simulation.trace->PrintStats(time_us_32());
+	g_simulation.backend->PrintStats();
+
+	g_simulation.backend->Close();
+	fflush(stdout);
+	exit(status);
+}
+
+
+static void OnSignal(int signal)
+{
+	(void)signal;
+	g_simulation.isStopRequested = 1;
+}
+
+
+int main(int argc, char **argv)
+{
+	g_simulation.backend = &g_uhidBackend;
+	g_simulation.trace = &g_trace;
+
+	const char *tracePath = nullptr;
+	for (int i = 1; i < argc; i++)
+	{
+		const bool hasValue = i + 1 < argc;
+
+		if (strcmp(argv[i], "--dump") == 0)
+			g_simulation.backend = &g_dumpBackend;
+		else if (strcmp(argv[i], "--probe") == 0)
+			g_simulation.backend = &g_probeBackend;
+		else if (strcmp(argv[i], "--probe-interval-ms") == 0 && hasValue)
+			g_probeBackend.SetInterval(strtoul(argv[++i], nullptr, 10) * 1000);
+		else if (strcmp(argv[i], "--repeat") == 0 && hasValue)
+			g_trace.SetRepeatCount(strtoul(argv[++i], nullptr, 10));
+		else if (strcmp(argv[i], "--poll-us") == 0 && hasValue)
+			g_simulation.pollIntervalUS = strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--delay-ms") == 0 && hasValue)
+			g_simulation.startDelayUS = strtoul(argv[++i], nullptr, 10) * 1000;
+		else if (strcmp(argv[i], "--linger-ms") == 0 && hasValue)
+			g_simulation.lingerUS = strtoul(argv[++i], nullptr, 10) * 1000;
+		else if (argv[i][0] != '-' && !tracePath)
+			tracePath = argv[i];
+		else
+		{
+			PrintUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (!tracePath)
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	if (!g_trace.Load(tracePath))
+		return 1;
+
+	if (!g_simulation.backend->Open())
+		return 1;
+
+	// Take the device down cleanly if we're stopped part way through.
+	signal(SIGINT, OnSignal);
+	signal(SIGTERM, OnSignal);
+
+	// The firmware runs until the trace is finished.
+	return CentreModuleMain();
+}
@@ -0,0 +1,32 @@
+#include "StackWatermark.h"
+
+#include <stdio.h>
+
+
+// The host's stacks aren't ours to paint, and the firmware's stack use doesn't carry over from another architecture,
+// so there's nothing to measure.
+
+void StackWatermark::Init() {}
+
+
+void StackWatermark::OnTask() {}
+
+
+uint32_t StackWatermark::GetHighWaterMark(size_t core) const
+{
+	(void)core;
+	return 0;
+}
+
+
+uint32_t StackWatermark::GetStackSize(size_t core) const
+{
+	(void)core;
+	return 0;
+}
+
+
+void StackWatermark::Print() const
+{
+	printf("Stack use isn't tracked in the simulation.\n");
+}
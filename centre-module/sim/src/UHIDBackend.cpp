@@ -0,0 +1,241 @@
+#include "UHIDBackend.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/uhid.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+
+static const char kUHIDPath[]{"/dev/uhid"};
+
+
+// uhid numbers its report types differently to HID.
+static hid_report_type_t ToReportType(uint8_t uhidType)
+{
+	switch (uhidType)
+	{
+		case UHID_FEATURE_REPORT: return HID_REPORT_TYPE_FEATURE;
+		case UHID_OUTPUT_REPORT: return HID_REPORT_TYPE_OUTPUT;
+		case UHID_INPUT_REPORT: return HID_REPORT_TYPE_INPUT;
+		default: return HID_REPORT_TYPE_INVALID;
+	}
+}
+
+
+static bool WriteEvent(int file, const struct uhid_event &event)
+{
+	if (write(file, &event, sizeof(event)) != static_cast<ssize_t>(sizeof(event)))
+	{
+		printf("uhid: write failed: %s\n", strerror(errno));
+		return false;
+	}
+
+	return true;
+}
+
+
+bool UHIDBackend::Open()
+{
+	const tusb_desc_device_t *device = reinterpret_cast<const tusb_desc_device_t *>(tud_descriptor_device_cb());
+
+	char productName[64];
+	HIDDescriptors::GetProductName(productName, sizeof(productName));
+
+	for (uint8_t instance = 0; instance < CFG_TUD_HID; instance++)
+	{
+		uhidFiles[instance] = open(kUHIDPath, O_RDWR | O_CLOEXEC | O_NONBLOCK);
+		if (uhidFiles[instance] < 0)
+		{
+			printf("uhid: can't open %s: %s\n", kUHIDPath, strerror(errno));
+			Close();
+			return false;
+		}
+
+		struct uhid_event event;
+		memset(&event, 0, sizeof(event));
+		event.type = UHID_CREATE2;
+
+		// Each player gets their own device, so give them their own names.
+		if (CFG_TUD_HID > 1)
+			snprintf(reinterpret_cast<char *>(event.u.create2.name), sizeof(event.u.create2.name), "%s P%u",
+			         productName, instance + 1);
+		else
+			snprintf(reinterpret_cast<char *>(event.u.create2.name), sizeof(event.u.create2.name), "%s", productName);
+		snprintf(reinterpret_cast<char *>(event.u.create2.phys), sizeof(event.u.create2.phys), "centre_module_sim/input%u",
+		         instance);
+
+		event.u.create2.rd_size = HIDDescriptors::GetReportDescriptorLength(instance);
+		memcpy(event.u.create2.rd_data, tud_hid_descriptor_report_cb(instance), event.u.create2.rd_size);
+		event.u.create2.bus = BUS_USB;
+		event.u.create2.vendor = device->idVendor;
+		event.u.create2.product = device->idProduct;
+		event.u.create2.version = device->bcdDevice;
+
+		if (!WriteEvent(uhidFiles[instance], event))
+		{
+			Close();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+void UHIDBackend::Close()
+{
+	for (uint8_t instance = 0; instance < CFG_TUD_HID; instance++)
+	{
+		if (uhidFiles[instance] <= 0)
+			continue;
+
+		struct uhid_event event;
+		memset(&event, 0, sizeof(event));
+		event.type = UHID_DESTROY;
+		WriteEvent(uhidFiles[instance], event);
+
+		close(uhidFiles[instance]);
+		uhidFiles[instance] = 0;
+		isInstanceStarted[instance] = false;
+	}
+
+	isStarted = false;
+}
+
+
+void UHIDBackend::OnTask()
+{
+	struct pollfd pollFiles[CFG_TUD_HID];
+	for (uint8_t instance = 0; instance < CFG_TUD_HID; instance++)
+	{
+		pollFiles[instance].fd = uhidFiles[instance];
+		pollFiles[instance].events = POLLIN;
+		pollFiles[instance].revents = 0;
+	}
+
+	// Don't wait, the main loop has switches to scan.
+	if (poll(pollFiles, CFG_TUD_HID, 0) <= 0)
+		return;
+
+	for (uint8_t instance = 0; instance < CFG_TUD_HID; instance++)
+	{
+		if (!(pollFiles[instance].revents & POLLIN))
+			continue;
+
+		struct uhid_event event;
+		while (read(uhidFiles[instance], &event, sizeof(event)) > 0)
+			OnEvent(instance, event);
+	}
+
+	isStarted = true;
+	for (uint8_t instance = 0; instance < CFG_TUD_HID; instance++)
+		isStarted = isStarted && isInstanceStarted[instance];
+}
+
+
+bool UHIDBackend::IsStarted() const
+{
+	return isStarted;
+}
+
+
+bool UHIDBackend::SendReport(uint8_t instance, const uint8_t *report, uint16_t length)
+{
+	struct uhid_event event;
+	memset(&event, 0, sizeof(event));
+	event.type = UHID_INPUT2;
+	event.u.input2.size = length;
+	memcpy(event.u.input2.data, report, length);
+
+	return WriteEvent(uhidFiles[instance], event);
+}
+
+
+void UHIDBackend::OnEvent(uint8_t instance, const struct uhid_event &event)
+{
+	switch (event.type)
+	{
+		case UHID_START: isInstanceStarted[instance] = true; break;
+
+		case UHID_STOP: isInstanceStarted[instance] = false; break;
+
+		case UHID_OPEN:
+		case UHID_CLOSE: break;
+
+		case UHID_OUTPUT:
+		{
+			// There's no OUT endpoint, so on USB these would come over the control endpoint as SET_REPORT.
+			const uint8_t reportID = event.u.output.size ? event.u.output.data[0] : 0;
+			SetReport(instance, reportID, ToReportType(event.u.output.rtype), event.u.output.data, event.u.output.size);
+			break;
+		}
+
+		case UHID_GET_REPORT: OnGetReport(instance, event); break;
+
+		case UHID_SET_REPORT: OnSetReport(instance, event); break;
+
+		default: break;
+	}
+}
+
+
+void UHIDBackend::OnGetReport(uint8_t instance, const struct uhid_event &event)
+{
+	struct uhid_event reply;
+	memset(&reply, 0, sizeof(reply));
+	reply.type = UHID_GET_REPORT_REPLY;
+	reply.u.get_report_reply.id = event.u.get_report.id;
+
+	// TinyUSB puts the report ID first, then asks for the rest, all in one endpoint buffer.
+	const uint8_t reportID = event.u.get_report.rnum;
+	uint16_t length = 0;
+	if (reportID)
+		reply.u.get_report_reply.data[length++] = reportID;
+
+	const uint16_t dataLength = tud_hid_get_report_cb(instance, reportID, ToReportType(event.u.get_report.rtype),
+	                                                  reply.u.get_report_reply.data + length,
+	                                                  CFG_TUD_HID_EP_BUFSIZE - length);
+
+	// Nothing means the request is stalled.
+	if (dataLength == 0)
+		reply.u.get_report_reply.err = EIO;
+	else
+		reply.u.get_report_reply.size = length + dataLength;
+
+	WriteEvent(uhidFiles[instance], reply);
+}
+
+
+void UHIDBackend::OnSetReport(uint8_t instance, const struct uhid_event &event)
+{
+	SetReport(instance, event.u.set_report.rnum, ToReportType(event.u.set_report.rtype), event.u.set_report.data,
+	          event.u.set_report.size);
+
+	struct uhid_event reply;
+	memset(&reply, 0, sizeof(reply));
+	reply.type = UHID_SET_REPORT_REPLY;
+	reply.u.set_report_reply.id = event.u.set_report.id;
+	reply.u.set_report_reply.err = 0;
+
+	WriteEvent(uhidFiles[instance], reply);
+}
+
+
+void UHIDBackend::SetReport(
+    uint8_t instance, uint8_t reportID, hid_report_type_t type, const uint8_t *data, uint16_t length)
+{
+	if (length > CFG_TUD_HID_EP_BUFSIZE)
+		length = CFG_TUD_HID_EP_BUFSIZE;
+
+	// TinyUSB strips the report ID before passing it on.
+	if (reportID && length > 1 && data[0] == reportID)
+	{
+		data++;
+		length--;
+	}
+
+	tud_hid_set_report_cb(instance, reportID, type, data, length);
+}
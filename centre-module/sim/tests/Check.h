@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdio.h>
+
+
+// Just enough of a test framework for the host tests. Each test is an executable of its own, registered with CTest,
+// which fails if any of its checks did.
+
+inline int g_checkCount = 0;
+inline int g_checkFailures = 0;
+
+#define CHECK(condition)                                                                                               \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		g_checkCount++;                                                                                                \
+		if (!(condition))                                                                                              \
+		{                                                                                                              \
+			g_checkFailures++;                                                                                         \
+			printf("%s:%d: CHECK(%s) failed.\n", __FILE__, __LINE__, #condition);                                      \
+		}                                                                                                              \
+	} while (0)
+
+#define CHECK_EQUAL(expected, actual)                                                                                  \
+	do                                                                                                                 \
+	{                                                                                                                  \
+		g_checkCount++;                                                                                                \
+		const long long expectedValue = (expected);                                                                    \
+		const long long actualValue = (actual);                                                                        \
+		if (expectedValue != actualValue)                                                                              \
+		{                                                                                                              \
+			g_checkFailures++;                                                                                         \
+			printf("%s:%d: CHECK_EQUAL(%s, %s) failed, expected %lld but got %lld.\n", __FILE__, __LINE__, #expected,  \
+			       #actual, expectedValue, actualValue);                                                               \
+		}                                                                                                              \
+	} while (0)
+
+
+// Print the totals. Returns the exit code for main.
+inline int FinishChecks(const char *testName)
+{
+	printf("%s: %d checks, %d failed.\n", testName, g_checkCount, g_checkFailures);
+	return g_checkFailures == 0 ? 0 : 1;
+}
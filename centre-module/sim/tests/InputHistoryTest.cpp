@@ -0,0 +1,267 @@
+#include "Check.h"
+#include "InputHistory.h"
+#include "ReportBytes.h"
+#include "tusb_config.h"
+#include "usb_descriptors.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+// Pages the size the control endpoint gives the feature report.
+static const uint16_t kPageBytes = FEATURE_REPORT_SIZE;
+
+
+// The report we record for a sequence number, so it can be checked again after reading it back. Every snapshot
+// changes the buttons and X, and the players take turns.
+static hid_gamepad_report_t MakeReport(uint32_t sequence)
+{
+	hid_gamepad_report_t report{};
+	report.buttons = sequence;
+	report.x = static_cast<int8_t>(sequence);
+	report.y = -100;
+	report.hat = GAMEPAD_HAT_CENTERED;
+	return report;
+}
+
+static void RecordSnapshots(InputHistory &history, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const uint32_t sequence = history.GetWriteSequence();
+		history.Record(static_cast<uint8_t>(sequence & 1), MakeReport(sequence), sequence * 1000);
+	}
+}
+
+
+static void MoveTo(InputHistory &history, uint32_t sequence)
+{
+	const uint8_t request[] = {static_cast<uint8_t>(sequence), static_cast<uint8_t>(sequence >> 8),
+	                           static_cast<uint8_t>(sequence >> 16), static_cast<uint8_t>(sequence >> 24)};
+	history.SetReport(request, sizeof(request));
+}
+
+
+// Check a page holds the snapshots from the first sequence number on. Returns the number in the page.
+static uint32_t CheckPage(const uint8_t *page, uint32_t firstSequence, uint32_t writeSequence)
+{
+	CHECK_EQUAL(firstSequence, ReadUInt32(page + 0));
+	CHECK_EQUAL(writeSequence, ReadUInt32(page + 4));
+
+	InputSnapshot snapshots[UINT8_MAX];
+	const uint32_t count = InputHistory::DecodeReport(page, kPageBytes, snapshots, UINT8_MAX);
+	CHECK_EQUAL(page[8], count);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const uint32_t sequence = firstSequence + i;
+		const hid_gamepad_report_t expected = MakeReport(sequence);
+
+		CHECK_EQUAL(sequence * 1000, snapshots[i].timeUS);
+		CHECK_EQUAL(sequence & 1, snapshots[i].player);
+		CHECK(memcmp(&expected, &snapshots[i].report, sizeof(expected)) == 0);
+	}
+
+	return count;
+}
+
+
+// The exact bytes for a page: each player's first snapshot has everything, the rest only what changed.
+static void TestEncoding()
+{
+	InputHistory history;
+
+	hid_gamepad_report_t report{};
+	report.buttons = 0x00000001;
+	report.hat = GAMEPAD_HAT_CENTERED;
+	report.x = -128;
+	history.Record(0, report, 1000000);
+
+	report.buttons = 0x00000003;
+	history.Record(0, report, 1000200);
+
+	report.y = 127;
+	history.Record(0, report, 1000300);
+
+	history.Record(1, report, 1000300);
+
+	uint8_t page[kPageBytes];
+	CHECK_EQUAL(kPageBytes, history.GetReport(page, kPageBytes));
+
+	const uint8_t expected[] = {
+	    // First sequence, write sequence and count.
+	    0, 0, 0, 0, 4, 0, 0, 0, 4,
+	    // Everything, with the time since 0.
+	    0xFE, 0xC0, 0x84, 0x3D, 0x01, 0x00, 0x00, 0x00, GAMEPAD_HAT_CENTERED, 0x80, 0, 0, 0, 0, 0,
+	    // The buttons 200us later.
+	    kInputSnapshotButtons, 0xC8, 0x01, 0x03, 0x00, 0x00, 0x00, GAMEPAD_HAT_CENTERED,
+	    // Y 100us after that.
+	    kInputSnapshotY, 0x64, 0x7F,
+	    // The second player's first, at the same time.
+	    0xFF, 0x00, 0x03, 0x00, 0x00, 0x00, GAMEPAD_HAT_CENTERED, 0x80, 0x7F, 0, 0, 0, 0};
+
+	CHECK(memcmp(expected, page, sizeof(expected)) == 0);
+	for (size_t i = sizeof(expected); i < sizeof(page); i++)
+		CHECK_EQUAL(0, page[i]);
+
+	InputSnapshot snapshots[4];
+	CHECK_EQUAL(4, InputHistory::DecodeReport(page, kPageBytes, snapshots, 4));
+	CHECK_EQUAL(1000300, snapshots[3].timeUS);
+	CHECK_EQUAL(1, snapshots[3].player);
+	CHECK_EQUAL(127, snapshots[2].report.y);
+	CHECK_EQUAL(-128, snapshots[2].report.x);
+	CHECK_EQUAL(3, snapshots[2].report.buttons);
+
+	// A page cut short only gives back the snapshots which are all there. The third one ends 35 bytes in.
+	CHECK_EQUAL(3, InputHistory::DecodeReport(page, 35, snapshots, 4));
+	CHECK_EQUAL(2, InputHistory::DecodeReport(page, 34, snapshots, 4));
+}
+
+
+// Times which take every length of the variable length encoding, including the wrap of the clock.
+static void TestTimes()
+{
+	const uint32_t kTimes[] = {0x7F, 0x80, 0x3FFF, 0x4000, 0x1FFFFF, 0x200000, 0xFFFFFFF, 0x10000000, 0xFFFFFFFF, 5};
+
+	InputHistory history;
+	for (uint32_t i = 0; i < sizeof(kTimes) / sizeof(kTimes[0]); i++)
+	{
+		hid_gamepad_report_t report{};
+		report.buttons = i;
+		history.Record(0, report, kTimes[i]);
+	}
+
+	uint32_t read = 0;
+	while (read < sizeof(kTimes) / sizeof(kTimes[0]))
+	{
+		MoveTo(history, read);
+
+		uint8_t page[kPageBytes];
+		history.GetReport(page, kPageBytes);
+
+		InputSnapshot snapshots[UINT8_MAX];
+		const uint32_t count = InputHistory::DecodeReport(page, kPageBytes, snapshots, UINT8_MAX);
+		CHECK(count > 0);
+		if (count == 0)
+			return;
+
+		for (uint32_t i = 0; i < count; i++)
+			CHECK_EQUAL(kTimes[read + i], snapshots[i].timeUS);
+		read += count;
+	}
+}
+
+
+// Getting the report again returns the same page, until the host sets the report to move on.
+static void TestGetDoesNotMove()
+{
+	InputHistory history;
+	RecordSnapshots(history, 20);
+
+	uint8_t page[kPageBytes];
+	CHECK_EQUAL(kPageBytes, history.GetReport(page, kPageBytes));
+	const uint32_t firstCount = CheckPage(page, 0, 20);
+	CHECK(firstCount >= 3);
+
+	memset(page, 0xEE, sizeof(page));
+	history.GetReport(page, kPageBytes);
+	CHECK_EQUAL(firstCount, CheckPage(page, 0, 20));
+
+	// Page through the rest, each one picking up where the last left off.
+	uint32_t read = firstCount;
+	while (read < 20)
+	{
+		MoveTo(history, read);
+		history.GetReport(page, kPageBytes);
+
+		const uint32_t count = CheckPage(page, read, 20);
+		CHECK(count > 0);
+		if (count == 0)
+			return;
+		read += count;
+	}
+	CHECK_EQUAL(20, read);
+
+	// Caught up, until something new is recorded.
+	MoveTo(history, 20);
+	history.GetReport(page, kPageBytes);
+	CHECK_EQUAL(0, CheckPage(page, 20, 20));
+
+	RecordSnapshots(history, 1);
+	history.GetReport(page, kPageBytes);
+	CHECK_EQUAL(1, CheckPage(page, 20, 21));
+
+	CHECK_EQUAL(0, history.GetReport(page, InputHistory::kReportHeaderBytes - 1));
+}
+
+
+// A reader which has fallen behind the ring starts again from the oldest snapshot still held.
+static void TestOverrun()
+{
+	InputHistory history;
+	RecordSnapshots(history, InputHistory::kSnapshotCount + 10);
+
+	uint8_t page[kPageBytes];
+	history.GetReport(page, kPageBytes);
+	CheckPage(page, 10, InputHistory::kSnapshotCount + 10);
+
+	MoveTo(history, InputHistory::kSnapshotCount + 8);
+	history.GetReport(page, kPageBytes);
+	CHECK_EQUAL(2, CheckPage(page, InputHistory::kSnapshotCount + 8, InputHistory::kSnapshotCount + 10));
+}
+
+
+// Read a whole ring of play, one player pressing buttons and moving the stick, and count the round trips. The README
+// quotes these.
+static void TestThroughput()
+{
+	InputHistory history;
+
+	hid_gamepad_report_t report{};
+	report.hat = GAMEPAD_HAT_CENTERED;
+	uint32_t timeUS = 0;
+	for (uint32_t i = 0; i < InputHistory::kSnapshotCount; i++)
+	{
+		// Half are a button going down or up, half the stick moving on one axis.
+		if (i & 1)
+			report.buttons ^= 1U << ((i >> 1) % 8);
+		else
+			report.x = static_cast<int8_t>(report.x + 5);
+
+		timeUS += 5000 + (i % 7) * 20000;
+		history.Record(0, report, timeUS);
+	}
+
+	uint32_t pages = 0;
+	uint32_t read = 0;
+	while (read < InputHistory::kSnapshotCount)
+	{
+		MoveTo(history, read);
+
+		uint8_t page[kPageBytes];
+		history.GetReport(page, kPageBytes);
+		if (page[8] == 0)
+			break;
+
+		read += page[8];
+		pages++;
+	}
+
+	CHECK_EQUAL(InputHistory::kSnapshotCount, read);
+
+	// Each page is a SET_REPORT and a GET_REPORT. At 16 bytes a snapshot this took 86 pages.
+	printf("InputHistoryTest: %u snapshots in %u pages, %.1f a page.\n", read, pages, static_cast<double>(read) / pages);
+	CHECK(pages <= 45);
+}
+
+
+int main()
+{
+	TestEncoding();
+	TestTimes();
+	TestGetDoesNotMove();
+	TestOverrun();
+	TestThroughput();
+
+	return FinishChecks("InputHistoryTest");
+}
@@ -0,0 +1,172 @@
+#include "Check.h"
+#include "HostPIO.h"
+#include "QuadratureInput.h"
+
+
+// The AB states going forwards, A in bit 0. Each one is a count.
+static const uint kForwardSequence[] = {0, 1, 3, 2};
+
+// Where the encoder is in kForwardSequence.
+static size_t g_phase = 2;
+
+
+// What each pair of previous and current AB states should do to the count. Going forwards or back one state is a
+// count either way. Staying put is nothing, and so is jumping two states, since we can't tell which way it went.
+struct TransitionCase
+{
+	uint previousAB;
+	uint currentAB;
+	HostPIO::Transition expected;
+};
+
+static const TransitionCase kTransitionCases[HostPIO::kTransitionCount] = {
+    {0b00, 0b00, HostPIO::kTransitionNone},
+    {0b00, 0b01, HostPIO::kTransitionIncrement},
+    {0b00, 0b10, HostPIO::kTransitionDecrement},
+    {0b00, 0b11, HostPIO::kTransitionNone}, // Invalid.
+    {0b01, 0b00, HostPIO::kTransitionDecrement},
+    {0b01, 0b01, HostPIO::kTransitionNone},
+    {0b01, 0b10, HostPIO::kTransitionNone}, // Invalid.
+    {0b01, 0b11, HostPIO::kTransitionIncrement},
+    {0b10, 0b00, HostPIO::kTransitionIncrement},
+    {0b10, 0b01, HostPIO::kTransitionNone}, // Invalid.
+    {0b10, 0b10, HostPIO::kTransitionNone},
+    {0b10, 0b11, HostPIO::kTransitionDecrement},
+    {0b11, 0b00, HostPIO::kTransitionNone}, // Invalid.
+    {0b11, 0b01, HostPIO::kTransitionDecrement},
+    {0b11, 0b10, HostPIO::kTransitionIncrement},
+    {0b11, 0b11, HostPIO::kTransitionNone},
+};
+
+
+// Turn the encoder, one state per loop of the program.
+static void Turn(uint sm, int counts)
+{
+	for (; counts > 0; counts--)
+	{
+		g_phase = (g_phase + 1) % 4;
+		HostPIO::SetPins(sm, kForwardSequence[g_phase]);
+	}
+	for (; counts < 0; counts++)
+	{
+		g_phase = (g_phase + 3) % 4;
+		HostPIO::SetPins(sm, kForwardSequence[g_phase]);
+	}
+}
+
+
+// The jump table at the top of the program, against the table above.
+static void TestTransitionTable()
+{
+	for (const TransitionCase &transition : kTransitionCases)
+	{
+		const HostPIO::Transition actual = HostPIO::GetTransition(transition.previousAB, transition.currentAB);
+		if (actual != transition.expected)
+			printf("%u%u -> %u%u:\n", transition.previousAB >> 1, transition.previousAB & 1, transition.currentAB >> 1,
+			       transition.currentAB & 1);
+		CHECK_EQUAL(transition.expected, actual);
+	}
+
+	// And the sequence we turn the encoder with does count the right way.
+	for (size_t i = 0; i < 4; i++)
+	{
+		const uint from = kForwardSequence[i];
+		const uint to = kForwardSequence[(i + 1) % 4];
+		CHECK_EQUAL(HostPIO::kTransitionIncrement, HostPIO::GetTransition(from, to));
+		CHECK_EQUAL(HostPIO::kTransitionDecrement, HostPIO::GetTransition(to, from));
+	}
+}
+
+
+// Counts short of a whole step are kept for the next report, in both directions.
+static void TestSubCountAccumulation()
+{
+	QuadratureInputGroup group;
+	group.Init();
+
+	CHECK(!group.OnTask());
+	CHECK_EQUAL(0, group.GetPendingSteps(kQuadratureOutputMouseX));
+
+	Turn(0, 3);
+	CHECK(group.OnTask());
+	CHECK_EQUAL(0, group.GetPendingSteps(kQuadratureOutputMouseX));
+
+	Turn(0, 1);
+	CHECK(group.OnTask());
+	CHECK_EQUAL(1, group.GetPendingSteps(kQuadratureOutputMouseX));
+	group.ConsumeSteps(kQuadratureOutputMouseX, 1);
+	CHECK_EQUAL(0, group.GetPendingSteps(kQuadratureOutputMouseX));
+
+	// Back past where we started.
+	Turn(0, -6);
+	CHECK(group.OnTask());
+	CHECK_EQUAL(-1, group.GetPendingSteps(kQuadratureOutputMouseX));
+	group.ConsumeSteps(kQuadratureOutputMouseX, -1);
+
+	Turn(0, -2);
+	CHECK(group.OnTask());
+	CHECK_EQUAL(-1, group.GetPendingSteps(kQuadratureOutputMouseX));
+
+	// A lot of motion between reports is sent over as many as it takes.
+	group.ConsumeSteps(kQuadratureOutputMouseX, -1);
+	Turn(0, 4 * 200);
+	CHECK(group.OnTask());
+	CHECK_EQUAL(127, group.GetPendingSteps(kQuadratureOutputMouseX));
+	group.ConsumeSteps(kQuadratureOutputMouseX, 127);
+	CHECK_EQUAL(73, group.GetPendingSteps(kQuadratureOutputMouseX));
+}
+
+
+// The FIFO fills long before the next task when the encoder is spinning fast, and the counts after that are dropped.
+// We should still end up with the latest count.
+static void TestFullFIFO()
+{
+	QuadratureInputGroup group;
+	group.Init();
+
+	Turn(0, 4 * 10);
+	CHECK(group.OnTask());
+	CHECK_EQUAL(10, group.GetPendingSteps(kQuadratureOutputMouseX));
+
+	// Nothing else moved, so nothing changes.
+	for (int i = 0; i < 20; i++)
+		HostPIO::RunLoop(0);
+	CHECK(!group.OnTask());
+	CHECK_EQUAL(10, group.GetPendingSteps(kQuadratureOutputMouseX));
+}
+
+
+// A glitch which skips a state is ignored rather than counted.
+static void TestInvalidTransition()
+{
+	QuadratureInputGroup group;
+	group.Init();
+
+	g_phase = (g_phase + 2) % 4;
+	HostPIO::SetPins(0, kForwardSequence[g_phase]);
+	CHECK(!group.OnTask());
+	CHECK_EQUAL(0, group.GetPendingSteps(kQuadratureOutputMouseX));
+}
+
+
+int main()
+{
+	if (!HostPIO::LoadProgram(QUADRATURE_PROGRAM_PATH))
+	{
+		printf("Couldn't load the jump table from '%s'.\n", QUADRATURE_PROGRAM_PATH);
+		return 1;
+	}
+
+	TestTransitionTable();
+
+	// Each of these starts from the pulled up state the program is seeded with.
+	void (*const groupTests[])() = {TestSubCountAccumulation, TestFullFIFO, TestInvalidTransition};
+	for (auto test : groupTests)
+	{
+		HostPIO::Reset();
+		g_phase = 2;
+		test();
+	}
+
+	return FinishChecks("QuadratureDecoderTest");
+}
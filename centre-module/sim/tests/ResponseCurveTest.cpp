@@ -0,0 +1,154 @@
+#include "Check.h"
+#include "ResponseCurve.h"
+#include <math.h>
+
+
+// The curves again, written out separately in double precision.
+
+static double ReferenceLinear(double x)
+{
+	return x;
+}
+
+
+static double ReferenceExponential(double x)
+{
+	return 0.4 * x + 0.6 * pow(x, 3.0);
+}
+
+
+static double ReferenceSCurve(double x)
+{
+	// Smoothstep on the distance from the centre.
+	const double t = fabs(x);
+	return copysign(3.0 * t * t - 2.0 * t * t * t, x);
+}
+
+
+static double ReferenceAntiDeadzone(double x)
+{
+	const double t = fabs(x);
+	if (t < 0.02)
+		return 0.0;
+
+	// 0.2 at the edge of the noise dead spot, rising in a straight line to 1 at full travel.
+	return copysign(0.2 + 0.8 * (t - 0.02) / 0.98, x);
+}
+
+
+static double (*const kReferenceCurves[kResponseCurveCount])(double){
+    ReferenceLinear,
+    ReferenceExponential,
+    ReferenceSCurve,
+    ReferenceAntiDeadzone,
+};
+
+
+// The stick position for an ADC code, from -1 to just under 1.
+static double GetPosition(int32_t code)
+{
+	return static_cast<double>(code - kResponseCurveMidPoint) / kResponseCurveMidPoint;
+}
+
+
+// The XInput value the reference gives. Floored and clamped like the tables, so a full deflection of 1 would be 127.
+static int32_t GetReferenceValue(ResponseCurveID curveID, int32_t code)
+{
+	const double value = floor(kReferenceCurves[curveID](GetPosition(code)) * 128.0);
+	return value > 127.0 ? 127 : (value < -128.0 ? -128 : static_cast<int32_t>(value));
+}
+
+
+// The tables are built in single precision, so where the reference lands right on a whole number the table can be one
+// under it. Anywhere else they have to agree exactly.
+static bool IsOnStepEdge(ResponseCurveID curveID, int32_t code)
+{
+	const double scaled = kReferenceCurves[curveID](GetPosition(code)) * 128.0;
+	return fabs(scaled - round(scaled)) < 1e-4;
+}
+
+
+// Every entry of every table against the reference.
+static void TestTablesMatchReference()
+{
+	for (int curve = 0; curve < kResponseCurveCount; curve++)
+	{
+		const ResponseCurveID curveID = static_cast<ResponseCurveID>(curve);
+		const int8_t *table = GetResponseCurve(curveID);
+
+		int mismatchCount = 0;
+		for (int32_t code = 0; code < static_cast<int32_t>(kResponseCurveTableSize); code++)
+		{
+			const int32_t expected = GetReferenceValue(curveID, code);
+			const int32_t difference = expected - table[code];
+
+			if (difference == 0 || (difference == 1 && IsOnStepEdge(curveID, code)))
+				continue;
+
+			// Only the first few, so one broken curve doesn't bury everything else.
+			if (++mismatchCount <= 5)
+				printf("%s: code %d is %d, the reference is %d.\n", GetResponseCurveName(curveID), code, table[code],
+				       expected);
+		}
+
+		CHECK_EQUAL(0, mismatchCount);
+	}
+}
+
+
+// The ends of the ADC range, and the outputs never leaving what fits in an int8_t.
+static void TestClamping()
+{
+	for (int curve = 0; curve < kResponseCurveCount; curve++)
+	{
+		const int8_t *table = GetResponseCurve(static_cast<ResponseCurveID>(curve));
+
+		// Full deflection one way is exactly -1. The other way the ADC stops a code short, which floors to 127.
+		CHECK_EQUAL(-128, table[0]);
+		CHECK_EQUAL(127, table[kResponseCurveTableSize - 1]);
+
+		// Centred is centred, and moving the stick never moves the output back the other way.
+		CHECK_EQUAL(0, table[kResponseCurveMidPoint]);
+		for (size_t code = 1; code < kResponseCurveTableSize; code++)
+			CHECK(table[code] >= table[code - 1]);
+	}
+}
+
+
+// The anti-deadzone curve's dead spot is 2% of the travel either side of centre, which is 40.96 codes.
+static void TestDeadzoneEdges()
+{
+	const int8_t *table = GetResponseCurve(kResponseCurveAntiDeadzone);
+
+	CHECK_EQUAL(0, table[kResponseCurveMidPoint + 40]);
+	CHECK_EQUAL(0, table[kResponseCurveMidPoint - 40]);
+
+	// Past it, the output jumps straight to the 20% most games ignore.
+	CHECK_EQUAL(25, table[kResponseCurveMidPoint + 41]);
+	CHECK_EQUAL(-26, table[kResponseCurveMidPoint - 41]);
+	CHECK_EQUAL(GetReferenceValue(kResponseCurveAntiDeadzone, kResponseCurveMidPoint + 41),
+	            table[kResponseCurveMidPoint + 41]);
+	CHECK_EQUAL(GetReferenceValue(kResponseCurveAntiDeadzone, kResponseCurveMidPoint - 41),
+	            table[kResponseCurveMidPoint - 41]);
+
+	// None of the other curves have a jump anywhere.
+	for (int curve = 0; curve < kResponseCurveCount; curve++)
+	{
+		if (curve == kResponseCurveAntiDeadzone)
+			continue;
+
+		const int8_t *otherTable = GetResponseCurve(static_cast<ResponseCurveID>(curve));
+		for (size_t code = 1; code < kResponseCurveTableSize; code++)
+			CHECK(otherTable[code] - otherTable[code - 1] <= 1);
+	}
+}
+
+
+int main()
+{
+	TestTablesMatchReference();
+	TestClamping();
+	TestDeadzoneEdges();
+
+	return FinishChecks("ResponseCurveTest");
+}
@@ -0,0 +1,148 @@
+#include "Check.h"
+#include "HostSPI.h"
+#include "MCP3208Model.h"
+#include "SPIAnalogueInput.h"
+
+
+// A different value for each channel and sweep, spread over the whole range so every bit gets used.
+static uint16_t GetTestValue(size_t channel, size_t sweep)
+{
+	return static_cast<uint16_t>((channel * 0x1F3 + sweep * 0x2A7 + 0x055) & MCP3208Model::kMaxValue);
+}
+
+
+// Each command should convert the channel it was made for, and the result should come back out of the bytes clocked
+// in alongside it.
+static void TestCommandEncoding()
+{
+	const uint16_t edgeValues[] = {0, 1, 0x800, 0xAAA, 0x555, MCP3208Model::kMaxValue};
+
+	for (uint8_t channel = 0; channel < MCP3208Model::kChannelCount; channel++)
+	{
+		for (uint16_t value : edgeValues)
+		{
+			MCP3208Model adc;
+			adc.SetValue(channel, value);
+
+			// The other channels shouldn't show through.
+			adc.SetValue(channel ^ 1, value ^ MCP3208Model::kMaxValue);
+
+			uint8_t command[SPIAnalogueInputGroup::kBytesPerConversion];
+			uint8_t sample[SPIAnalogueInputGroup::kBytesPerConversion];
+			SPIAnalogueInputGroup::EncodeCommand(channel, command);
+
+			adc.Select();
+			for (size_t i = 0; i < SPIAnalogueInputGroup::kBytesPerConversion; i++)
+				sample[i] = adc.Transfer(command[i]);
+			adc.Deselect();
+
+			CHECK_EQUAL(1, adc.GetConversionCount());
+			CHECK_EQUAL(channel, adc.GetLastChannel());
+			CHECK(adc.WasLastSingleEnded());
+			CHECK_EQUAL(value, SPIAnalogueInputGroup::DecodeSample(sample));
+		}
+	}
+}
+
+
+// Run whole sweeps through the DMA for every axis count. The slots ring around buffers sized to the next power of
+// two, so the later sweeps only come out right if the rings wrap where the firmware thinks they do.
+static void TestSweeps()
+{
+	const size_t kSweepCount{3};
+
+	for (size_t axisCount = 1; axisCount <= SPIAnalogueInputGroup::kMaxAxisCount; axisCount++)
+	{
+		HostSPI::Reset();
+		MCP3208Model adc;
+		HostSPI::Attach(&adc);
+
+		SPIAnalogueInputGroup group(axisCount, 1000);
+		group.Init();
+
+		size_t slotCount = 1;
+		while (slotCount < axisCount)
+			slotCount <<= 1;
+
+		// One conversion per slot per sweep, to within the timer's whole number divider. It can't divide by more than
+		// 65535, so a short sweep goes faster than asked.
+		const uint32_t timerRate = HostSPI::GetTimerRate(0);
+		const uint32_t minimumTimerRate = 125000000 / 0xFFFF;
+		CHECK(timerRate >= 1000 * slotCount || timerRate == minimumTimerRate);
+		CHECK(timerRate < 1000 * slotCount * 101 / 100 || timerRate == minimumTimerRate);
+
+		for (size_t sweep = 0; sweep < kSweepCount; sweep++)
+		{
+			for (uint8_t channel = 0; channel < MCP3208Model::kChannelCount; channel++)
+				adc.SetValue(channel, GetTestValue(channel, sweep));
+
+			for (size_t slot = 0; slot < slotCount; slot++)
+			{
+				HostSPI::TickTimer(0);
+				CHECK_EQUAL(SPIAnalogueInputGroup::kBytesPerConversion, HostSPI::ClockAll());
+
+				// The spare slots convert channel 0 again.
+				CHECK_EQUAL(slot < axisCount ? slot : 0, adc.GetLastChannel());
+			}
+
+			CHECK_EQUAL(slotCount * (sweep + 1), adc.GetConversionCount());
+
+			group.OnTask();
+			for (size_t axis = 0; axis < axisCount; axis++)
+				CHECK_EQUAL(GetTestValue(axis, sweep), group.GetRawValue(axis));
+		}
+	}
+}
+
+
+// A slot the DMA is part way through writing should keep its last value rather than mixing the old and new bytes.
+static void TestBusySlot()
+{
+	const uint16_t kOldValue{0x0FF};
+	const uint16_t kNewValue{0xF00};
+
+	HostSPI::Reset();
+	MCP3208Model adc;
+	HostSPI::Attach(&adc);
+
+	SPIAnalogueInputGroup group(4, 1000);
+	group.Init();
+
+	for (uint8_t channel = 0; channel < 4; channel++)
+		adc.SetValue(channel, kOldValue);
+
+	for (size_t slot = 0; slot < 4; slot++)
+	{
+		HostSPI::TickTimer(0);
+		HostSPI::ClockAll();
+	}
+	group.OnTask();
+	CHECK_EQUAL(kOldValue, group.GetRawValue(0));
+
+	// Three bytes in, the high nibble of the result has landed and the low byte hasn't.
+	for (uint8_t channel = 0; channel < 4; channel++)
+		adc.SetValue(channel, kNewValue);
+
+	HostSPI::TickTimer(0);
+	for (int i = 0; i < 3; i++)
+		CHECK(HostSPI::ClockByte());
+
+	group.OnTask();
+	CHECK_EQUAL(kOldValue, group.GetRawValue(0));
+	CHECK_EQUAL(kOldValue, group.GetRawValue(1));
+
+	HostSPI::ClockAll();
+	group.OnTask();
+	CHECK_EQUAL(kNewValue, group.GetRawValue(0));
+	CHECK_EQUAL(kOldValue, group.GetRawValue(1));
+}
+
+
+int main()
+{
+	TestCommandEncoding();
+	TestSweeps();
+	TestBusySlot();
+
+	return FinishChecks("SPIAnalogueInputTest");
+}
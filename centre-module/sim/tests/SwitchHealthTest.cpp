@@ -0,0 +1,307 @@
+#include "Check.h"
+#include "DigitalInput.h"
+#include "ReportBytes.h"
+#include "SwitchHealth.h"
+#include "tusb_config.h"
+#include "usb_descriptors.h"
+
+#include "hardware/gpio.h"
+#include "pico/time.h"
+#include <string.h>
+
+
+// The test plays the part of the pins and the clock. The switches pull up, so everything starts off released.
+static uint32_t g_gpioState = 0xFFFFFFFF;
+static uint32_t g_timeUS = 1000000;
+
+uint32_t time_us_32(void)
+{
+	return g_timeUS;
+}
+
+uint32_t gpio_get_all(void)
+{
+	return g_gpioState;
+}
+
+void gpio_init_mask(uint gpio_mask)
+{
+	(void)gpio_mask;
+}
+
+void gpio_set_dir_in_masked(uint32_t mask)
+{
+	(void)mask;
+}
+
+void gpio_pull_up(uint gpio)
+{
+	(void)gpio;
+}
+
+
+// A panel with its switches and their health.
+struct Panel
+{
+	DigitalInputGroup inputs;
+	SwitchHealth health;
+
+	explicit Panel(uint32_t reservedPins = 0)
+	{
+		g_gpioState = 0xFFFFFFFF;
+		inputs.ReservePins(reservedPins);
+		inputs.Init();
+		health.Init(&inputs);
+	}
+
+	// Press or release a switch some time after the last change, and scan it like the main loop does.
+	void SetSwitch(size_t input, bool isPressed, uint32_t afterUS)
+	{
+		const uint32_t pin = 1U << inputs.GetInputGPIO(input);
+		g_gpioState = isPressed ? (g_gpioState & ~pin) : (g_gpioState | pin);
+		g_timeUS += afterUS;
+
+		if (inputs.OnTask())
+			health.OnInputsChanged(inputs.GetLastChangeTime());
+	}
+
+	// Get a page of the feature report, as the host would through the control endpoint.
+	uint16_t GetPage(size_t firstInput, uint8_t *buffer, uint16_t length = FEATURE_REPORT_SIZE)
+	{
+		const uint8_t request[] = {static_cast<uint8_t>(firstInput), 0};
+		health.SetReport(request, sizeof(request));
+
+		memset(buffer, 0xEE, length);
+		return health.GetReport(buffer, length);
+	}
+};
+
+
+// A full page has to fit in what TinyUSB gives us for GET_REPORT, after the report ID.
+static void TestPageSize()
+{
+	const size_t kPageBytes = SwitchHealth::kReportHeaderBytes + 5 * SwitchHealth::kReportBytesPerSwitch;
+
+	CHECK_EQUAL(63, kPageBytes);
+	CHECK_EQUAL(CFG_TUD_HID_EP_BUFSIZE - 1, kPageBytes);
+	CHECK_EQUAL(FEATURE_REPORT_SIZE, kPageBytes);
+
+	// So the whole buffer goes on five switches, without any padding.
+	Panel panel;
+	uint8_t page[FEATURE_REPORT_SIZE];
+	CHECK_EQUAL(FEATURE_REPORT_SIZE, panel.GetPage(0, page));
+	CHECK_EQUAL(5, page[2]);
+	CHECK_EQUAL(panel.inputs.GetInputGPIO(4), page[SwitchHealth::kReportHeaderBytes + 4 * 12 + 11]);
+}
+
+
+// Each field of a switch's entry, and moving through the pages.
+static void TestReportEncoding()
+{
+	Panel panel;
+	const size_t inputCount = panel.inputs.GetInputCount();
+
+	// Two clean presses of the first switch.
+	panel.SetSwitch(0, true, 100000);
+	panel.SetSwitch(0, false, 100000);
+	panel.SetSwitch(0, true, 80000);
+	panel.SetSwitch(0, false, 250000);
+
+	// A press which bounces straight back up, and a chattering one.
+	panel.SetSwitch(1, true, 100000);
+	panel.SetSwitch(1, false, 2000);
+	panel.SetSwitch(1, true, 100000);
+	panel.SetSwitch(1, false, 10000);
+
+	// Left held down.
+	panel.SetSwitch(2, true, 100000);
+
+	uint8_t page[FEATURE_REPORT_SIZE];
+	CHECK_EQUAL(FEATURE_REPORT_SIZE, panel.GetPage(0, page));
+	CHECK_EQUAL(0, page[0]);
+	CHECK_EQUAL(inputCount, page[1]);
+	CHECK_EQUAL(5, page[2]);
+
+	const uint8_t *entry = page + SwitchHealth::kReportHeaderBytes;
+	CHECK_EQUAL(2, ReadUInt16(entry + 0));
+	CHECK_EQUAL(0, ReadUInt16(entry + 2));
+	CHECK_EQUAL(0, ReadUInt16(entry + 4));
+	CHECK_EQUAL(100, ReadUInt16(entry + 6));
+	CHECK_EQUAL(250, ReadUInt16(entry + 8));
+	CHECK_EQUAL(0, entry[10]);
+	CHECK_EQUAL(panel.inputs.GetInputGPIO(0), entry[11]);
+
+	entry += SwitchHealth::kReportBytesPerSwitch;
+	CHECK_EQUAL(2, ReadUInt16(entry + 0));
+	CHECK_EQUAL(1, ReadUInt16(entry + 2));
+	CHECK_EQUAL(1, ReadUInt16(entry + 4));
+	CHECK_EQUAL(10, ReadUInt16(entry + 6));
+	CHECK_EQUAL(10, ReadUInt16(entry + 8));
+	CHECK_EQUAL(0, entry[10]);
+	CHECK_EQUAL(panel.inputs.GetInputGPIO(1), entry[11]);
+
+	entry += SwitchHealth::kReportBytesPerSwitch;
+	CHECK_EQUAL(1, ReadUInt16(entry + 0));
+	CHECK_EQUAL(UINT16_MAX, ReadUInt16(entry + 6));
+	CHECK_EQUAL(0, ReadUInt16(entry + 8));
+	CHECK_EQUAL(kSwitchHealthPressed, entry[10]);
+
+	// The next page starts where it was asked to.
+	CHECK_EQUAL(FEATURE_REPORT_SIZE, panel.GetPage(5, page));
+	CHECK_EQUAL(5, page[0]);
+	CHECK_EQUAL(5, page[2]);
+	CHECK_EQUAL(panel.inputs.GetInputGPIO(5), page[SwitchHealth::kReportHeaderBytes + 11]);
+
+	// The last page is short, and padded out with zeros.
+	CHECK_EQUAL(FEATURE_REPORT_SIZE, panel.GetPage(inputCount - 2, page));
+	CHECK_EQUAL(2, page[2]);
+	for (size_t i = SwitchHealth::kReportHeaderBytes + 2 * SwitchHealth::kReportBytesPerSwitch; i < sizeof(page); i++)
+		CHECK_EQUAL(0, page[i]);
+
+	// Past the end goes back to the start.
+	panel.GetPage(inputCount, page);
+	CHECK_EQUAL(0, page[0]);
+
+	// Too short for even the header.
+	CHECK_EQUAL(0, panel.GetPage(0, page, SwitchHealth::kReportHeaderBytes - 1));
+
+	// Resetting clears the counts, but keeps what's held down.
+	const uint8_t reset[] = {0, 1};
+	panel.health.SetReport(reset, sizeof(reset));
+	panel.GetPage(0, page);
+	entry = page + SwitchHealth::kReportHeaderBytes;
+	CHECK_EQUAL(0, ReadUInt16(entry + 0));
+	CHECK_EQUAL(kSwitchHealthPressed, entry[2 * SwitchHealth::kReportBytesPerSwitch + 10]);
+}
+
+
+// Pins taken by the encoders never change, and shouldn't be reported as stuck off when everything else gets used.
+static void TestReservedPinsAreNotStuck()
+{
+	const uint32_t kEncoderPins = 3U << 14;
+
+	Panel panel(kEncoderPins);
+	const size_t inputCount = panel.inputs.GetInputCount();
+
+	// The last switch in use is never pressed.
+	size_t neglectedInput = inputCount;
+	size_t reservedCount = 0;
+	for (size_t i = 0; i < inputCount; i++)
+	{
+		const bool isReserved = (kEncoderPins & (1U << panel.inputs.GetInputGPIO(i))) != 0;
+		CHECK_EQUAL(!isReserved, panel.inputs.IsInputInUse(i));
+		CHECK_EQUAL(isReserved ? kSwitchHealthNotInUse : 0, panel.health.GetStats(i).flags);
+
+		if (isReserved)
+			reservedCount++;
+		else
+			neglectedInput = i;
+	}
+	CHECK_EQUAL(2, reservedCount);
+
+	// The neglected switch works for a while, then everything else gets worn in.
+	for (uint16_t i = 0; i < SwitchHealth::kStuckOffMinPresses; i++)
+	{
+		panel.SetSwitch(neglectedInput, true, 50000);
+		panel.SetSwitch(neglectedInput, false, 50000);
+		panel.SetSwitch(0, true, 50000);
+		panel.SetSwitch(0, false, 50000);
+	}
+
+	size_t presses = 0;
+	for (size_t input = 0; presses <= SwitchHealth::kStuckOffPanelPresses; input = (input + 1) % inputCount)
+	{
+		if (input == neglectedInput || !panel.inputs.IsInputInUse(input))
+			continue;
+
+		panel.SetSwitch(input, true, 50000);
+		panel.SetSwitch(input, false, 50000);
+		presses++;
+	}
+
+	g_timeUS += 1100000;
+	panel.health.OnTask();
+
+	for (size_t i = 0; i < inputCount; i++)
+	{
+		const uint8_t flags = panel.health.GetStats(i).flags;
+		if (i == neglectedInput)
+			CHECK_EQUAL(kSwitchHealthStuckOff, flags);
+		else if (!panel.inputs.IsInputInUse(i))
+			CHECK_EQUAL(kSwitchHealthNotInUse, flags);
+		else
+			CHECK_EQUAL(0, flags);
+	}
+}
+
+
+// Press a switch and release it again.
+static void Tap(Panel &panel, size_t input)
+{
+	panel.SetSwitch(input, true, 50000);
+	panel.SetSwitch(input, false, 50000);
+}
+
+
+// Run the once a second stuck checks, and return the switch's flags.
+static uint8_t CheckStuck(Panel &panel, size_t input)
+{
+	g_timeUS += 1100000;
+	panel.health.OnTask();
+	return panel.health.GetStats(input).flags;
+}
+
+
+// A switch which goes a long time between presses is given longer before it's called stuck off, and one which has
+// hardly been used isn't judged at all.
+static void TestStuckOffScalesWithUse()
+{
+	const size_t kBusyInput = 0;
+	const size_t kStartInput = 1;
+	const size_t kCoinInput = 2;
+	const uint32_t kStartGap = 500;
+
+	Panel panel;
+
+	// Start is pressed every 500 presses of the panel, and the coin switch twice.
+	Tap(panel, kCoinInput);
+	Tap(panel, kCoinInput);
+	for (uint16_t i = 0; i < SwitchHealth::kStuckOffMinPresses; i++)
+	{
+		for (uint32_t j = 0; j < kStartGap - 1; j++)
+			Tap(panel, kBusyInput);
+		Tap(panel, kStartInput);
+	}
+
+	// Past the plain threshold, but not past eight of start's usual gaps.
+	uint32_t sinceStart = 0;
+	for (; sinceStart <= SwitchHealth::kStuckOffPanelPresses; sinceStart++)
+		Tap(panel, kBusyInput);
+	CHECK_EQUAL(0, CheckStuck(panel, kStartInput));
+	CHECK_EQUAL(0, CheckStuck(panel, kCoinInput));
+
+	for (; sinceStart < SwitchHealth::kStuckOffGapMultiple * kStartGap - 10; sinceStart++)
+		Tap(panel, kBusyInput);
+	CHECK_EQUAL(0, CheckStuck(panel, kStartInput));
+
+	// Eight gaps on it does look stuck, and the coin switch still hasn't been used enough to tell.
+	for (; sinceStart <= SwitchHealth::kStuckOffGapMultiple * kStartGap + 10; sinceStart++)
+		Tap(panel, kBusyInput);
+	CHECK_EQUAL(kSwitchHealthStuckOff, CheckStuck(panel, kStartInput));
+	CHECK_EQUAL(0, CheckStuck(panel, kCoinInput));
+
+	// Pressing it clears the flag.
+	Tap(panel, kStartInput);
+	CHECK_EQUAL(0, CheckStuck(panel, kStartInput));
+}
+
+
+int main()
+{
+	TestPageSize();
+	TestReportEncoding();
+	TestReservedPinsAreNotStuck();
+	TestStuckOffScalesWithUse();
+
+	return FinishChecks("SwitchHealthTest");
+}
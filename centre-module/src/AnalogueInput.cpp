@@ -7,21 +7,33 @@
 
 void AnalogueInputGroup::Init()
 {
-	printf("Analogue pins:\n\n");
+	adc_init();
 
 	// Initialise all the analogue pins.
 	for (uint i = 0; i < kPinCount; i++)
 	{
-		printf("Init PinId: %d - GPIO: %d.\n", i, analogueInputs[i].gpioSwitchId);
 		adc_gpio_init(analogueInputs[i].gpioSwitchId);
 
 		// Default the raw input values to the mid-position.
 		// NOTE: This might be entirely wrong for a controller like a thrust stick.
-		analogueInputs[i] = AnalogueInput::midPointADCValue;
+		analogueInputs[i].value = AnalogueInput::midPointADCValue;
 	}
 }
 
 
+void AnalogueInputGroup::PrintDiagnostics()
+{
+	printf("Analogue pins:\n\n");
+
+	for (uint i = 0; i < kPinCount; i++)
+	{
+		printf("Init PinId: %d - GPIO: %d.\n", i, analogueInputs[i].gpioSwitchId);
+	}
+
+	printf("\n");
+}
+
+
 bool AnalogueInputGroup::OnTask()
 {
 	// uint32_t startTaskTime = time_us_32();
@@ -0,0 +1,37 @@
+#include "BootProfile.h"
+
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include <stdio.h>
+
+
+static const char *const kBootPhaseNames[kBootPhaseCount]{
+    "Main entered", "USB started", "Digital ready", "Mounted", "First report", "Deferred init",
+};
+
+
+void BootProfile::Mark(BootPhase phase)
+{
+	if (HasReached(phase))
+		return;
+
+	// NOTE: The timer starts during the SDK runtime init, so the time spent in the boot ROM and boot2 is not counted.
+	phaseTimes[phase] = time_us_32();
+	reachedPhases |= (1U << phase);
+}
+
+
+void BootProfile::Print() const
+{
+	printf("Boot profile:\n\n");
+
+	for (int i = 0; i < kBootPhaseCount; i++)
+	{
+		if (HasReached(static_cast<BootPhase>(i)))
+			printf("%-14s %8u us\n", kBootPhaseNames[i], phaseTimes[i]);
+		else
+			printf("%-14s        - \n", kBootPhaseNames[i]);
+	}
+
+	printf("\n");
+}
@@ -0,0 +1,153 @@
+#include "ClockProfile.h"
+
+#include "hardware/clocks.h"
+#include "hardware/vreg.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+
+struct ClockProfile
+{
+	// Friendly name for the profile.
+	const char *name;
+
+	// System clock frequency.
+	uint32_t sysClockKHz;
+
+	// Core voltage needed to run at that frequency.
+	enum vreg_voltage voltage;
+};
+
+
+// NOTE: The USB needs the system clock to be at least 48MHz, so that's as low as we can go. Flash runs at half the
+// system clock, 125MHz is still inside what the Pico's flash is rated for.
+static const ClockProfile kClockProfiles[kClockProfileCount]{
+    {"Idle", 48000, VREG_VOLTAGE_1_10},
+    {"Standard", 125000, VREG_VOLTAGE_1_10},
+    {"Competition", 250000, VREG_VOLTAGE_1_15},
+};
+
+// Time to let the regulator settle after raising the voltage.
+static const uint32_t kVoltageSettleUS{1000};
+
+// Measurement windows between printing the stats.
+static const uint32_t kStatsPrintWindows{10};
+
+
+void ClockProfiles::Init()
+{
+	clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, 48 * MHZ, 48 * MHZ);
+
+	// We come up at the SDK default.
+	currentProfile = kClockProfileStandard;
+	loopCount = 0;
+	windowStartTime = time_us_32();
+}
+
+
+bool ClockProfiles::Select(ClockProfileID profileID)
+{
+	if (profileID == currentProfile)
+		return false;
+
+	const ClockProfile &from = kClockProfiles[currentProfile];
+	const ClockProfile &to = kClockProfiles[profileID];
+
+	// Raise the voltage before the clock goes up, and drop it after the clock comes down.
+	if (to.voltage > from.voltage)
+	{
+		vreg_set_voltage(to.voltage);
+		sleep_us(kVoltageSettleUS);
+	}
+
+	if (!set_sys_clock_khz(to.sysClockKHz, false))
+	{
+		printf("Clock: %s at %u kHz is not possible.\n", to.name, to.sysClockKHz);
+		vreg_set_voltage(from.voltage);
+		return false;
+	}
+
+	if (to.voltage < from.voltage)
+		vreg_set_voltage(to.voltage);
+
+	printf("Clock: %s -> %s, %u kHz.\n", from.name, to.name, to.sysClockKHz);
+
+	// Start a fresh measurement window for the new profile.
+	currentProfile = profileID;
+	loopCount = 0;
+	windowStartTime = time_us_32();
+
+	return true;
+}
+
+
+uint32_t ClockProfiles::GetSysClockKHz() const
+{
+	return kClockProfiles[currentProfile].sysClockKHz;
+}
+
+
+void ClockProfiles::OnReport(uint32_t inputTime, uint32_t reportTime)
+{
+	ClockProfileStats &profileStats = stats[currentProfile];
+	const uint32_t latency = reportTime - inputTime;
+
+	if (latency < profileStats.minLatencyUS)
+		profileStats.minLatencyUS = latency;
+	if (latency > profileStats.maxLatencyUS)
+		profileStats.maxLatencyUS = latency;
+	profileStats.totalLatencyUS += latency;
+	profileStats.latencyCount++;
+}
+
+
+void ClockProfiles::OnTask()
+{
+	const uint32_t currentTime = time_us_32();
+	const uint32_t elapsed = currentTime - windowStartTime;
+
+	if (elapsed < 1000000)
+		return;
+
+	ClockProfileStats &profileStats = stats[currentProfile];
+	profileStats.loopsPerSecond = static_cast<uint32_t>((static_cast<uint64_t>(loopCount) * 1000000) / elapsed);
+
+	loopCount = 0;
+	windowStartTime = currentTime;
+
+	if (++windowCount >= kStatsPrintWindows)
+	{
+		PrintStats();
+		windowCount = 0;
+	}
+}
+
+
+void ClockProfiles::PrintStats() const
+{
+	printf("Clock profiles:\n\n");
+
+	for (size_t i = 0; i < kClockProfileCount; i++)
+	{
+		const ClockProfileStats &profileStats = stats[i];
+
+		// A switch change can wait up to a whole loop before it's scanned, so add that on for the worst case.
+		const uint32_t loopTimeUS = profileStats.loopsPerSecond ? 1000000 / profileStats.loopsPerSecond : 0;
+
+		printf("%c%-12s %6u kHz  %7u loops/s  ", i == currentProfile ? '*' : ' ', kClockProfiles[i].name,
+		    kClockProfiles[i].sysClockKHz, profileStats.loopsPerSecond);
+
+		if (profileStats.latencyCount)
+		{
+			printf("latency %u / %u / %u us (min / avg / max), worst case %u us\n", profileStats.minLatencyUS,
+			    static_cast<uint32_t>(profileStats.totalLatencyUS / profileStats.latencyCount),
+			    profileStats.maxLatencyUS, profileStats.maxLatencyUS + loopTimeUS);
+		}
+		else
+		{
+			printf("latency -\n");
+		}
+	}
+
+	printf("\n");
+}
@@ -5,6 +5,7 @@
 #include "tusb.h"
 
 
+#if PANEL_PLAYER_COUNT == 1
 class DigitalInput switchArray[]{
     // Joystick.
     {2, GAMEPAD_BUTTON_5, "Joy Up"},    // Up - HACK: Should be GAMEPAD_HAT_UP
@@ -43,27 +44,94 @@ class DigitalInput switchArray[]{
     // Top panel. Extra
     {22, GAMEPAD_BUTTON_19, "Insert Coin"}, // Insert coin
 };
+#elif PANEL_PLAYER_COUNT == 2
+// Two players side by side, each with a stick, four buttons and start. The coin slots are on the front.
+class DigitalInput switchArray[]{
+    // Player 1 joystick.
+    {2, GAMEPAD_BUTTON_5, "P1 Joy Up", 0},    // Up - HACK: Should be GAMEPAD_HAT_UP
+    {3, GAMEPAD_BUTTON_6, "P1 Joy Down", 0},  // Down - HACK: Should be GAMEPAD_HAT_DOWN
+    {4, GAMEPAD_BUTTON_7, "P1 Joy Right", 0}, // Right -HACK: Should be  GAMEPAD_HAT_RIGHT
+    {5, GAMEPAD_BUTTON_8, "P1 Joy Left", 0},  // Left - HACK: Should be GAMEPAD_HAT_LEFT
+
+    // Player 1 buttons.
+    {6, GAMEPAD_BUTTON_SOUTH, "P1 B1", 0},
+    {7, GAMEPAD_BUTTON_EAST, "P1 B2", 0},
+    {8, GAMEPAD_BUTTON_WEST, "P1 B3", 0},
+    {9, GAMEPAD_BUTTON_NORTH, "P1 B4", 0},
+    {10, GAMEPAD_BUTTON_START, "P1 Start", 0},
+
+    // Player 2 joystick.
+    {11, GAMEPAD_BUTTON_5, "P2 Joy Up", 1},    // Up - HACK: Should be GAMEPAD_HAT_UP
+    {12, GAMEPAD_BUTTON_6, "P2 Joy Down", 1},  // Down - HACK: Should be GAMEPAD_HAT_DOWN
+    {13, GAMEPAD_BUTTON_7, "P2 Joy Right", 1}, // Right -HACK: Should be  GAMEPAD_HAT_RIGHT
+    {14, GAMEPAD_BUTTON_8, "P2 Joy Left", 1},  // Left - HACK: Should be GAMEPAD_HAT_LEFT
+
+    // Player 2 buttons.
+    {15, GAMEPAD_BUTTON_SOUTH, "P2 B1", 1},
+    {16, GAMEPAD_BUTTON_EAST, "P2 B2", 1},
+    {17, GAMEPAD_BUTTON_WEST, "P2 B3", 1},
+    {18, GAMEPAD_BUTTON_NORTH, "P2 B4", 1},
+    {19, GAMEPAD_BUTTON_START, "P2 Start", 1},
+
+    // Front panel coin slots.
+    {20, GAMEPAD_BUTTON_SELECT, "P1 Coin", 0},
+    {21, GAMEPAD_BUTTON_SELECT, "P2 Coin", 1},
+};
+#else
+#error "There is no switch layout for this many players"
+#endif
+
+// The number of switches in the layout.
+static const size_t kDigitalInputCount{sizeof(switchArray) / sizeof(switchArray[0])};
+static_assert(kDigitalInputCount <= DigitalInputGroup::kMaxInputCount, "Too many switches for the input bitsets");
 
 
 void DigitalInputGroup::Init()
 {
-	// uint32_t initTime = time_us_32();
+	// Gather up all the switch pins so they can be configured together.
+	gpioMask = 0;
+	for (size_t i = 0; i < 32; i++)
+		gpioToInput[i] = kNoInput;
 
-	printf("Digital pins:\n\n");
-
-	// Initialise all the switches.
 	for (size_t i = 0; i < kDigitalInputCount; i++)
 	{
-		printf("Init PinId: %d - GPIO: %d.\n", i, switchArray[i].gpioSwitchId);
-
-		// Initialise the switch pins for input.
-		gpio_init(switchArray[i].gpioSwitchId);
-		gpio_set_dir(switchArray[i].gpioSwitchId, GPIO_IN);
-		gpio_pull_up(switchArray[i].gpioSwitchId);
-
 		// Give everything else sensible defaults.
-		// switchArray[i].timeStateWasEntered = initTime;
 		switchArray[i].isPressed = false;
+
+		// These switches will never change state.
+		if (reservedMask & (1U << switchArray[i].gpioSwitchId))
+			continue;
+
+		gpioMask |= (1U << switchArray[i].gpioSwitchId);
+		gpioToInput[switchArray[i].gpioSwitchId] = static_cast<uint8_t>(i);
+	}
+
+	// The switches pull up, so they all start off released.
+	lastGPIOState = gpioMask;
+	inputStates.ResetAll();
+
+	// Initialise the switch pins for input. This also sets them to be inputs.
+	gpio_init_mask(gpioMask);
+	gpio_set_dir_in_masked(gpioMask);
+
+	// NOTE: The SDK has no masked call for the pulls, so walk the set bits instead.
+	for (uint32_t pins = gpioMask; pins; pins &= pins - 1)
+	{
+		gpio_pull_up(__builtin_ctz(pins));
+	}
+}
+
+
+void DigitalInputGroup::PrintDiagnostics()
+{
+	printf("Digital pins:\n\n");
+
+	for (size_t i = 0; i < kDigitalInputCount; i++)
+	{
+		if (gpioMask & (1U << switchArray[i].gpioSwitchId))
+			printf("Init PinId: %d - GPIO: %d - Player: %d.\n", i, switchArray[i].gpioSwitchId, switchArray[i].player);
+		else
+			printf("Init PinId: %d - GPIO: %d - reserved.\n", i, switchArray[i].gpioSwitchId);
 	}
 
 	printf("\n");
@@ -77,40 +145,49 @@ bool DigitalInputGroup::OnTask()
 	// uint32_t endTaskTime;
 
 	// Default is for nothing to happen.
-	hasStateChanged = false;
+	changedPlayers = 0;
+	changedInputs.ResetAll();
 
-	// Get all the GPIO values at once. Mask out the ones we don't want e.g. 0 and 1 for UART, anything above 22.
+	// Get all the GPIO values at once. Mask out the ones which don't have a switch e.g. 0 and 1 for UART.
 	uint32_t gpioAll = gpio_get_all();
-	gpioAll &= 0x00FFFFFC;
+	gpioAll &= gpioMask;
 
-	// Detect their state.
-	for (size_t i = 0; i < kDigitalInputCount; i++)
+	// Only the pins which changed need any work.
+	const uint32_t gpioChanged = gpioAll ^ lastGPIOState;
+	lastGPIOState = gpioAll;
+	if (gpioChanged)
+		lastChangeTime = currentTime;
+
+	for (uint32_t pins = gpioChanged; pins; pins &= pins - 1)
 	{
-		// Get their pressed state.
-		const bool currentSwitchState = gpioAll & (1U << (switchArray[i].gpioSwitchId));
+		const uint32_t gpio = __builtin_ctz(pins);
+		const size_t i = gpioToInput[gpio];
+		DigitalInput &input = switchArray[i];
+
+		// The switches pull the pin low when pressed.
+		const bool isPressed = (gpioAll & (1U << gpio)) == 0;
+
+		// The state has changed for this frame.
+		changedInputs.Set(i);
+		changedPlayers |= (1U << input.player);
 
-		// State change - make something happen.
-		if (switchArray[i].isPressed != currentSwitchState)
+		// Switch went on or off?
+		if (isPressed)
 		{
-			// The state has changed for this frame.
-			hasStateChanged = true;
-
-			// Switch went on or off?
-			if (currentSwitchState)
-			{
-				digitalSwitches &= ~switchArray[i].mappedKey;
-				printf("-%s  CT: %u\n", switchArray[i].mappedKeyName.c_str(), currentTime);
-			}
-			else
-			{
-				digitalSwitches |= switchArray[i].mappedKey;
-				printf("+%s CT: %u\n", switchArray[i].mappedKeyName.c_str(), currentTime);
-			}
-
-			// Entering a new state, reset the time now.
-			switchArray[i].timeStateWasEntered = currentTime;
-			switchArray[i].isPressed = currentSwitchState;
+			inputStates.Set(i);
+			playerButtons[input.player] |= input.mappedKey;
+			printf("+%s CT: %u\n", input.mappedKeyName, currentTime);
 		}
+		else
+		{
+			inputStates.Reset(i);
+			playerButtons[input.player] &= ~input.mappedKey;
+			printf("-%s  CT: %u\n", input.mappedKeyName, currentTime);
+		}
+
+		// Entering a new state, reset the time now.
+		input.timeStateWasEntered = currentTime;
+		input.isPressed = isPressed;
 	}
 
 	// HACK: DEBUG: checking the button state every so often.
@@ -124,17 +201,35 @@ bool DigitalInputGroup::OnTask()
 		// printf("Digital Duration = %d\n", endTaskTime - startTaskTime);
 	}
 
-	return hasStateChanged;
+	return changedPlayers != 0;
 }
 
 
 bool DigitalInputGroup::HasStateChanged()
 {
-	return hasStateChanged;
+	return changedPlayers != 0;
+}
+
+
+size_t DigitalInputGroup::GetInputCount() const
+{
+	return kDigitalInputCount;
+}
+
+
+uint32_t DigitalInputGroup::GetInputGPIO(size_t input) const
+{
+	return switchArray[input].gpioSwitchId;
+}
+
+
+bool DigitalInputGroup::IsInputInUse(size_t input) const
+{
+	return (gpioMask & (1U << switchArray[input].gpioSwitchId)) != 0;
 }
 
 
-uint32_t DigitalInputGroup::GetState()
+const char *DigitalInputGroup::GetInputName(size_t input) const
 {
-	return digitalSwitches;
+	return switchArray[input].mappedKeyName;
 }
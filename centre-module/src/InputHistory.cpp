@@ -0,0 +1,205 @@
+#include "InputHistory.h"
+#include "ReportBytes.h"
+
+#include <string.h>
+
+static_assert(PANEL_PLAYER_COUNT <= InputHistory::kPlayerCount, "The history can't tell that many players apart");
+
+
+// Seven bits a byte, low first, with the top bit set on all but the last.
+static inline uint8_t *WriteVarUInt32(uint8_t *buffer, uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		*buffer++ = static_cast<uint8_t>(value | 0x80);
+		value >>= 7;
+	}
+	*buffer++ = static_cast<uint8_t>(value);
+	return buffer;
+}
+
+
+// The axes in the order they're sent, with the field bit for each.
+static const uint8_t kAxisFields[] = {kInputSnapshotX,  kInputSnapshotY,  kInputSnapshotZ,
+                                      kInputSnapshotRz, kInputSnapshotRx, kInputSnapshotRy};
+
+static inline int8_t GetAxis(const hid_gamepad_report_t &report, size_t axis)
+{
+	switch (axis)
+	{
+		case 0: return report.x;
+		case 1: return report.y;
+		case 2: return report.z;
+		case 3: return report.rz;
+		case 4: return report.rx;
+		default: return report.ry;
+	}
+}
+
+static inline void SetAxis(hid_gamepad_report_t &report, size_t axis, int8_t value)
+{
+	switch (axis)
+	{
+		case 0: report.x = value; break;
+		case 1: report.y = value; break;
+		case 2: report.z = value; break;
+		case 3: report.rz = value; break;
+		case 4: report.rx = value; break;
+		default: report.ry = value; break;
+	}
+}
+
+
+// Write a snapshot, with only the parts which differ from the player's last one. Returns the end of it.
+static uint8_t *EncodeSnapshot(uint8_t *buffer, const InputSnapshot &snapshot, const InputSnapshot *previous,
+                               uint32_t timeSinceUS)
+{
+	const hid_gamepad_report_t &report = snapshot.report;
+
+	uint8_t fields = snapshot.player ? kInputSnapshotPlayer : 0;
+	if (!previous || report.buttons != previous->report.buttons || report.hat != previous->report.hat)
+		fields |= kInputSnapshotButtons;
+	for (size_t axis = 0; axis < sizeof(kAxisFields); axis++)
+	{
+		if (!previous || GetAxis(report, axis) != GetAxis(previous->report, axis))
+			fields |= kAxisFields[axis];
+	}
+
+	uint8_t *write = buffer;
+	*write++ = fields;
+	write = WriteVarUInt32(write, timeSinceUS);
+
+	if (fields & kInputSnapshotButtons)
+	{
+		write = WriteUInt32(write, report.buttons);
+		*write++ = report.hat;
+	}
+	for (size_t axis = 0; axis < sizeof(kAxisFields); axis++)
+	{
+		if (fields & kAxisFields[axis])
+			*write++ = static_cast<uint8_t>(GetAxis(report, axis));
+	}
+
+	return write;
+}
+
+
+uint16_t InputHistory::GetReport(uint8_t *buffer, uint16_t length) const
+{
+	if (length < kReportHeaderBytes)
+		return 0;
+
+	// Anything older than the ring holds has been written over, so start from the oldest we have.
+	const uint32_t heldCount = writeSequence < kSnapshotCount ? writeSequence : kSnapshotCount;
+	uint32_t firstSequence = readSequence;
+	if (writeSequence - firstSequence > heldCount)
+		firstSequence = writeSequence - heldCount;
+
+	// Fit in as many as there's room for. Each is encoded to the side first, since we only know its size after.
+	const InputSnapshot *previous[kPlayerCount]{};
+	uint32_t previousTimeUS = 0;
+	uint32_t count = 0;
+	uint8_t *write = buffer + kReportHeaderBytes;
+
+	for (uint32_t sequence = firstSequence; sequence != writeSequence && count < UINT8_MAX; sequence++)
+	{
+		const InputSnapshot &snapshot = snapshots[sequence & (kSnapshotCount - 1)];
+		const uint8_t player = snapshot.player < kPlayerCount ? snapshot.player : 0;
+
+		uint8_t encoded[kMaxReportBytesPerSnapshot];
+		const uint8_t *encodedEnd = EncodeSnapshot(encoded, snapshot, previous[player], snapshot.timeUS - previousTimeUS);
+		const size_t encodedBytes = encodedEnd - encoded;
+		if (write + encodedBytes > buffer + length)
+			break;
+
+		memcpy(write, encoded, encodedBytes);
+		write += encodedBytes;
+
+		previous[player] = &snapshot;
+		previousTimeUS = snapshot.timeUS;
+		count++;
+	}
+
+	uint8_t *header = buffer;
+	header = WriteUInt32(header, firstSequence);
+	header = WriteUInt32(header, writeSequence);
+	*header++ = static_cast<uint8_t>(count);
+
+	return PadReport(buffer, write, length);
+}
+
+
+void InputHistory::SetReport(const uint8_t *buffer, uint16_t length)
+{
+	if (length < 4)
+		return;
+
+	readSequence = ReadUInt32(buffer);
+}
+
+
+uint32_t InputHistory::DecodeReport(const uint8_t *buffer, uint16_t length, InputSnapshot *pageSnapshots,
+                                    uint32_t maxCount)
+{
+	if (length < kReportHeaderBytes)
+		return 0;
+
+	uint32_t count = buffer[8];
+	if (count > maxCount)
+		count = maxCount;
+
+	const uint8_t *read = buffer + kReportHeaderBytes;
+	const uint8_t *end = buffer + length;
+	const InputSnapshot *previous[kPlayerCount]{};
+	uint32_t timeUS = 0;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (read >= end)
+			return i;
+
+		InputSnapshot &snapshot = pageSnapshots[i];
+		const uint8_t fields = *read++;
+		snapshot.player = (fields & kInputSnapshotPlayer) ? 1 : 0;
+
+		uint32_t timeSinceUS = 0;
+		for (uint32_t shift = 0;; shift += 7)
+		{
+			if (read >= end || shift > 28)
+				return i;
+			const uint8_t byte = *read++;
+			timeSinceUS |= static_cast<uint32_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				break;
+		}
+		timeUS += timeSinceUS;
+		snapshot.timeUS = timeUS;
+
+		// Anything left out is as it was.
+		if (previous[snapshot.player])
+			snapshot.report = previous[snapshot.player]->report;
+		else
+			memset(&snapshot.report, 0, sizeof(snapshot.report));
+
+		if (fields & kInputSnapshotButtons)
+		{
+			if (end - read < 5)
+				return i;
+			snapshot.report.buttons = ReadUInt32(read);
+			snapshot.report.hat = read[4];
+			read += 5;
+		}
+		for (size_t axis = 0; axis < sizeof(kAxisFields); axis++)
+		{
+			if (!(fields & kAxisFields[axis]))
+				continue;
+			if (read >= end)
+				return i;
+			SetAxis(snapshot.report, axis, static_cast<int8_t>(*read++));
+		}
+
+		previous[snapshot.player] = &snapshot;
+	}
+
+	return count;
+}
@@ -0,0 +1,35 @@
+#include "LatencyProbe.h"
+
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include "usb_descriptors.h"
+
+static_assert(LatencyProbe::kProbeBytes == LATENCY_PROBE_SIZE, "The descriptor and the probe disagree on its size");
+static_assert(LatencyProbe::kEchoBytes == LATENCY_PROBE_ECHO_SIZE, "The descriptor and the echo disagree on its size");
+
+
+void LatencyProbe::OnProbe(const uint8_t *buffer, uint16_t length)
+{
+	// Stamp it before anything else, it's the time the host is measuring against.
+	const uint32_t receiveTimeUS = time_us_32();
+
+	if (length < kProbeBytes)
+		return;
+
+	// A new probe replaces one still waiting, the host has given up on that one.
+	probeSequence = ReadUInt32(buffer);
+	probeHostTime = ReadUInt32(buffer + 4);
+	probeReceiveTimeUS = receiveTimeUS;
+	isProbePending = true;
+}
+
+
+void LatencyProbe::GetEcho(uint8_t *buffer, uint32_t sendTimeUS) const
+{
+	WriteUInt32(buffer, probeSequence);
+	WriteUInt32(buffer + 4, probeHostTime);
+	WriteUInt32(buffer + 8, probeReceiveTimeUS);
+	WriteUInt32(buffer + 12, sendTimeUS);
+	WriteUInt32(buffer + 16, scanToReportUS);
+	WriteUInt32(buffer + 20, scanToReportCount);
+}
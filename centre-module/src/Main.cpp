@@ -1,6 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <string>
+#include <string.h>
 
 #include "bsp/board.h"
 #include "tusb.h"
@@ -11,7 +11,16 @@
 #include "pico/time.h"
 
 #include "AnalogueInput.h"
+#include "BootProfile.h"
+#include "ClockProfile.h"
 #include "DigitalInput.h"
+#include "InputHistory.h"
+#include "LatencyProbe.h"
+#include "QuadratureInput.h"
+#include "SPIAnalogueInput.h"
+#include "StackWatermark.h"
+#include "SwitchHealth.h"
+#include "TinyUSBCompat.h"
 
 
 // Blink pattern times.
@@ -22,54 +31,237 @@ enum
 	blinkIntervalSuspended = 2500,
 };
 
+// The clock profile to run at while the bus is active.
+#ifndef DEFAULT_CLOCK_PROFILE
+#define DEFAULT_CLOCK_PROFILE kClockProfileStandard
+#endif
+
+// If the host never takes a report from us e.g. running on the bench with only the UART attached, we still want the
+// deferred initialisation to happen eventually.
+const uint32_t kDeferredInitTimeoutUS{2000000};
+
 uint32_t lastTaskTime;
 
 uint32_t blinkIntervalMS = blinkIntervalNotMounted;
 
 static DigitalInputGroup g_digitalInputGroup;
+#if SPI_ADC
+static SPIAnalogueInputGroup g_analogueSwitchGroup{SPI_ADC_AXIS_COUNT};
+#else
 static AnalogueInputGroup g_analogueSwitchGroup;
+#endif
+#if QUADRATURE
+static QuadratureInputGroup g_quadratureInputGroup;
+#endif
+static BootProfile g_bootProfile;
+static StackWatermark g_stackWatermark;
+static SwitchHealth g_switchHealth;
+static InputHistory g_inputHistory;
+static LatencyProbe g_latencyProbe;
+
+// The last report each gamepad sent, so GET_REPORT can be answered straight away.
+static hid_gamepad_report_t g_gamepadReports[PANEL_PLAYER_COUNT]{};
+
+// When the first switch change not yet carried by a report was scanned, for each player. The endpoint is often busy
+// on the frame a switch changes, so the report carrying it can be a few frames later.
+static bool g_hasUnreportedChange[PANEL_PLAYER_COUNT]{};
+static uint32_t g_unreportedChangeTime[PANEL_PLAYER_COUNT]{};
+static ClockProfiles g_clockProfiles;
+
+// The response curve picked by the player for the sticks.
+static ResponseCurveID g_responseCurve = kResponseCurveLinear;
+
+// The clock profile picked by the player. We drop to idle while suspended, whatever this is.
+static ClockProfileID g_selectedClockProfile = DEFAULT_CLOCK_PROFILE;
+
+// Have the analogue inputs and diagnostics been brought up yet?
+static bool g_isDeferredInitComplete = false;
+
+
+// The XInput value of an axis, or centred if the analogue group doesn't have that many. In a fast boot the first
+// reports go out before the analogue inputs are up, so they're held centred until then rather than reading the empty
+// value through the response curve.
+static int8_t GetAxis(size_t axisID)
+{
+	if (!g_isDeferredInitComplete || axisID >= g_analogueSwitchGroup.GetAxisCount())
+		return 0;
+
+	return g_analogueSwitchGroup.GetXBox(axisID);
+}
 
 
-static void SendGamepadHIDReport(uint8_t report_id)
+// Returns true if a report was sent.
+static bool SendMouseHIDReport()
 {
-	// skip if hid is not ready yet
-	if (!tud_hid_ready())
-		return;
+#if QUADRATURE
+	const int8_t x = g_quadratureInputGroup.GetPendingSteps(kQuadratureOutputMouseX);
+	const int8_t y = g_quadratureInputGroup.GetPendingSteps(kQuadratureOutputMouseY);
+
+	// Nothing moved far enough for a whole step, keep the counts for next time.
+	if (x == 0 && y == 0)
+		return false;
+
+	if (!tud_hid_mouse_report(REPORT_ID_MOUSE, 0, x, y, 0, 0))
+		return false;
+
+	g_quadratureInputGroup.ConsumeSteps(kQuadratureOutputMouseX, x);
+	g_quadratureInputGroup.ConsumeSteps(kQuadratureOutputMouseY, y);
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+// Each player's gamepad is on the HID instance with the same number.
+// Returns true if a report was sent.
+static bool SendGamepadHIDReport(uint8_t instance)
+{
+	bool wasSent = false;
 
 	// use to avoid send multiple consecutive zero report for keyboard
-	static bool hasGamepadKey = false;
+	static bool hasGamepadKey[PANEL_PLAYER_COUNT]{};
+
+	// The host should see our state as soon as it's ready for it, rather than waiting for the first change.
+	static bool hasSentFirstReport[PANEL_PLAYER_COUNT]{};
 
+	// Each player has a stick on the next pair of axes.
 	hid_gamepad_report_t gampadReport = {
-	    .x = static_cast<int8_t>(g_analogueSwitchGroup.GetXBox(0)),
-	    .y = static_cast<int8_t>(g_analogueSwitchGroup.GetXBox(1)),
+	    .x = GetAxis(instance * 2),
+	    .y = GetAxis(instance * 2 + 1),
+#if SPI_ADC && PANEL_PLAYER_COUNT == 1
+	    // Second stick and the pedals.
+	    .z = GetAxis(2),
+	    .rz = GetAxis(3),
+	    .rx = GetAxis(4),
+	    .ry = GetAxis(5),
+#else
 	    .z = 0,
 	    .rz = 0,
 	    .rx = 0,
 	    .ry = 0,
+#endif
 	    .hat = 0,
 	    .buttons = 0};
 
-	if (g_digitalInputGroup.HasStateChanged() || g_analogueSwitchGroup.HasStateChanged())
+	bool hasStateChanged = g_digitalInputGroup.HasStateChanged(instance) || g_analogueSwitchGroup.HasStateChanged();
+
+#if QUADRATURE
+	// Encoders used as axes take over from the analogue inputs on the first player's gamepad.
+	if (instance == 0)
+	{
+		if (g_quadratureInputGroup.HasOutput(kQuadratureOutputGamepadZ))
+			gampadReport.z = g_quadratureInputGroup.GetPosition(kQuadratureOutputGamepadZ);
+		if (g_quadratureInputGroup.HasOutput(kQuadratureOutputGamepadRz))
+			gampadReport.rz = g_quadratureInputGroup.GetPosition(kQuadratureOutputGamepadRz);
+
+		hasStateChanged |= g_quadratureInputGroup.HasStateChanged();
+	}
+#endif
+
+	if (!hasSentFirstReport[instance] || hasStateChanged)
 	{
 		// Normal report.
 		gampadReport.hat = GAMEPAD_HAT_CENTERED; // TODO: Use joystick for the hat.
-		gampadReport.buttons = g_digitalInputGroup.GetState();
-		tud_hid_report(REPORT_ID_GAMEPAD, &gampadReport, sizeof(gampadReport));
+		gampadReport.buttons = g_digitalInputGroup.GetState(instance);
+		wasSent = tud_hid_n_report(instance, REPORT_ID_GAMEPAD, &gampadReport, sizeof(gampadReport));
+		if (wasSent)
+		{
+			// The analogue inputs always count as changed, so only keep the reports which actually differ.
+			if (!hasSentFirstReport[instance] ||
+			    memcmp(&gampadReport, &g_gamepadReports[instance], sizeof(gampadReport)) != 0)
+				g_inputHistory.Record(instance, gampadReport, time_us_32());
+
+			g_gamepadReports[instance] = gampadReport;
+		}
+
+		if (wasSent && !hasSentFirstReport[instance])
+		{
+			g_bootProfile.Mark(kBootPhaseFirstReport);
+			hasSentFirstReport[instance] = true;
+		}
 
-		hasGamepadKey = true;
+		hasGamepadKey[instance] = true;
 	}
 	else
 	{
 		// Empty report.
 		gampadReport.hat = GAMEPAD_HAT_CENTERED;
 		// gampadReport.buttons = 0;
-		gampadReport.buttons = g_digitalInputGroup.GetState();
+		gampadReport.buttons = g_digitalInputGroup.GetState(instance);
+
+		if (hasGamepadKey[instance])
+			wasSent = tud_hid_n_report(instance, REPORT_ID_GAMEPAD, &gampadReport, sizeof(gampadReport));
+		if (wasSent)
+			g_gamepadReports[instance] = gampadReport;
+
+		hasGamepadKey[instance] = false;
+	}
+
+	// Time the switch changes from the scan to the report carrying them.
+	if (wasSent && g_hasUnreportedChange[instance])
+	{
+		const uint32_t reportTime = time_us_32();
+		g_clockProfiles.OnReport(g_unreportedChangeTime[instance], reportTime);
+		g_latencyProbe.OnReport(g_unreportedChangeTime[instance], reportTime);
+		g_hasUnreportedChange[instance] = false;
+	}
+
+	return wasSent;
+}
+
 
-		if (hasGamepadKey)
-			tud_hid_report(REPORT_ID_GAMEPAD, &gampadReport, sizeof(gampadReport));
+// Echo the host's latency probe back, if it sent one. The echo goes on the end of the first instance's report chain,
+// and holds off while the gamepad has a switch change to report so it never delays one.
+// Returns true if a report was sent.
+static bool SendLatencyProbeEcho()
+{
+	const uint32_t sendTime = time_us_32();
+	if (!g_latencyProbe.IsEchoDue(sendTime) || g_hasUnreportedChange[0])
+		return false;
+
+	uint8_t echo[LatencyProbe::kEchoBytes];
+	g_latencyProbe.GetEcho(echo, sendTime);
+	if (!tud_hid_n_report(0, REPORT_ID_LATENCY_PROBE, echo, sizeof(echo)))
+		return false;
+
+	g_latencyProbe.OnEchoSent(sendTime);
+	return true;
+}
+
+
+// Work along the reports from this one until one of them is sent. The rest follow on from
+// tud_hid_report_complete_cb().
+
+static void SendHIDReport(uint8_t instance, uint8_t report_id)
+{
+	// skip if hid is not ready yet
+	if (!tud_hid_n_ready(instance))
+		return;
 
-		hasGamepadKey = false;
+	for (; report_id <= REPORT_ID_LAST_CHAINED; report_id++)
+	{
+		switch (report_id)
+		{
+			case REPORT_ID_MOUSE:
+				// Only the first instance has a mouse.
+				if (instance == 0 && SendMouseHIDReport())
+					return;
+				break;
+
+			case REPORT_ID_GAMEPAD:
+				if (SendGamepadHIDReport(instance))
+					return;
+				break;
+
+			default: break;
+		}
 	}
+
+	// The probes come in on the first instance, so they go back out on it too.
+	if (instance == 0)
+		SendLatencyProbeEcho();
 }
 
 //--------------------------------------------------------------------+
@@ -81,6 +273,7 @@ static void SendGamepadHIDReport(uint8_t report_id)
 void tud_mount_cb(void)
 {
 	blinkIntervalMS = blinkIntervalMounted;
+	g_bootProfile.Mark(kBootPhaseMounted);
 }
 
 
@@ -115,16 +308,14 @@ void tud_resume_cb(void)
 // Application can use this to send the next report
 // Note: For composite reports, report[0] is report ID
 
-void tud_hid_report_complete_cb(uint8_t instance, uint8_t const *report, uint8_t len)
+void tud_hid_report_complete_cb(uint8_t instance, uint8_t const *report, HIDReportLength len)
 {
-	(void)instance;
 	(void)len;
 
-	uint8_t next_report_id = report[0] + 1;
-
-	if (next_report_id < REPORT_ID_COUNT)
+	// Carry on along the chain, through to the probe's echo at the end of it.
+	if (report[0] <= REPORT_ID_LAST_CHAINED)
 	{
-		SendGamepadHIDReport(next_report_id);
+		SendHIDReport(instance, report[0] + 1);
 	}
 }
 
@@ -136,14 +327,46 @@ void tud_hid_report_complete_cb(uint8_t instance, uint8_t const *report, uint8_t
 uint16_t tud_hid_get_report_cb(
     uint8_t instance, uint8_t report_id, hid_report_type_t report_type, uint8_t *buffer, uint16_t reqlen)
 {
-	// TODO not Implemented
-	(void)instance;
-	(void)report_id;
-	(void)report_type;
-	(void)buffer;
-	(void)reqlen;
+	// Hosts which poll over the control endpoint get the last report we sent. The mouse is relative, so it hasn't moved
+	// since then, and the keyboard and consumer control are never pressed.
+	if (report_type == HID_REPORT_TYPE_INPUT)
+	{
+		uint16_t length = 0;
+		switch (report_id)
+		{
+			case REPORT_ID_GAMEPAD:
+				length = TU_MIN(reqlen, sizeof(hid_gamepad_report_t));
+				memcpy(buffer, &g_gamepadReports[instance], length);
+				return length;
 
-	return 0;
+			case REPORT_ID_KEYBOARD: length = sizeof(hid_keyboard_report_t); break;
+			case REPORT_ID_MOUSE: length = sizeof(hid_mouse_report_t); break;
+			case REPORT_ID_CONSUMER_CONTROL: length = sizeof(uint16_t); break;
+			case REPORT_ID_LATENCY_PROBE: length = LatencyProbe::kEchoBytes; break;
+
+			default: return 0;
+		}
+
+		// Only the first instance has these.
+		if (instance != 0)
+			return 0;
+
+		length = TU_MIN(reqlen, length);
+		memset(buffer, 0, length);
+		return length;
+	}
+
+	// The diagnostics all live on the first instance.
+	if (instance != 0 || report_type != HID_REPORT_TYPE_FEATURE)
+		return 0;
+
+	switch (report_id)
+	{
+		case REPORT_ID_SWITCH_HEALTH: return g_switchHealth.GetReport(buffer, reqlen);
+		case REPORT_ID_INPUT_HISTORY: return g_inputHistory.GetReport(buffer, reqlen);
+
+		default: return 0;
+	}
 }
 
 
@@ -153,7 +376,24 @@ uint16_t tud_hid_get_report_cb(
 void tud_hid_set_report_cb(
     uint8_t instance, uint8_t report_id, hid_report_type_t report_type, uint8_t const *buffer, uint16_t bufsize)
 {
-	(void)instance;
+	// Stamp the probe as soon as it arrives, whichever way it was sent.
+	if (instance == 0 && report_id == REPORT_ID_LATENCY_PROBE)
+	{
+		g_latencyProbe.OnProbe(buffer, bufsize);
+		return;
+	}
+
+	if (instance == 0 && report_type == HID_REPORT_TYPE_FEATURE)
+	{
+		switch (report_id)
+		{
+			case REPORT_ID_SWITCH_HEALTH: g_switchHealth.SetReport(buffer, bufsize); break;
+			case REPORT_ID_INPUT_HISTORY: g_inputHistory.SetReport(buffer, bufsize); break;
+
+			default: break;
+		}
+		return;
+	}
 
 	if (report_type == HID_REPORT_TYPE_OUTPUT)
 	{
@@ -200,8 +440,75 @@ void SendHIDTask(void)
 	}
 	else
 	{
-		// Send the 1st of report chain, the rest will be sent by tud_hid_report_complete_cb()
-		SendGamepadHIDReport(REPORT_ID_GAMEPAD);
+		// Send the 1st of report chain for each player, the rest will be sent by tud_hid_report_complete_cb()
+		for (uint8_t instance = 0; instance < CFG_TUD_HID; instance++)
+			SendHIDReport(instance, REPORT_ID_KEYBOARD);
+	}
+}
+
+
+// Note the time of any switch changes the players' gamepads haven't reported yet.
+
+void NoteUnreportedChanges(void)
+{
+	for (size_t player = 0; player < PANEL_PLAYER_COUNT; player++)
+	{
+		if (g_digitalInputGroup.HasStateChanged(player) && !g_hasUnreportedChange[player])
+		{
+			g_hasUnreportedChange[player] = true;
+			g_unreportedChangeTime[player] = g_digitalInputGroup.GetLastChangeTime();
+		}
+	}
+}
+
+
+// Hold select and start, then press a face button to pick the clock profile, or north to step through the response
+// curves.
+
+void CheckHotkeys(void)
+{
+	const uint32_t kHotkeyModifier = GAMEPAD_BUTTON_SELECT | GAMEPAD_BUTTON_START;
+	static uint32_t lastButtons = 0;
+
+	// Only act on buttons as they go down.
+	const uint32_t buttons = g_digitalInputGroup.GetState(0);
+	const uint32_t pressedButtons = buttons & ~lastButtons;
+	lastButtons = buttons;
+
+	if ((buttons & kHotkeyModifier) != kHotkeyModifier)
+		return;
+
+	if (pressedButtons & GAMEPAD_BUTTON_NORTH)
+	{
+		g_responseCurve = static_cast<ResponseCurveID>((g_responseCurve + 1) % kResponseCurveCount);
+		for (size_t i = 0; i < g_analogueSwitchGroup.GetAxisCount(); i++)
+			g_analogueSwitchGroup.SetResponseCurve(i, g_responseCurve);
+
+		printf("Response curve: %s.\n", GetResponseCurveName(g_responseCurve));
+	}
+	else if (pressedButtons & GAMEPAD_BUTTON_WEST)
+		g_selectedClockProfile = kClockProfileIdle;
+	else if (pressedButtons & GAMEPAD_BUTTON_SOUTH)
+		g_selectedClockProfile = kClockProfileStandard;
+	else if (pressedButtons & GAMEPAD_BUTTON_EAST)
+		g_selectedClockProfile = kClockProfileCompetition;
+}
+
+
+// Run at the selected clock profile, dropping to idle while the bus is suspended.
+
+void ClockProfileTask(void)
+{
+	const ClockProfileID wantedProfile = tud_suspended() ? kClockProfileIdle : g_selectedClockProfile;
+
+	if (wantedProfile != g_clockProfiles.GetCurrent() && g_clockProfiles.Select(wantedProfile))
+	{
+#if SPI_ADC
+		// The sweeps are paced from the system clock. This is the rate we were getting on the last profile.
+		printf("SPI ADC: %u conversions/s.\n", g_analogueSwitchGroup.GetConversionRate());
+		g_analogueSwitchGroup.SetSampleRate(g_analogueSwitchGroup.GetSampleRate());
+#endif
+		g_clockProfiles.PrintStats();
 	}
 }
 
@@ -225,25 +532,73 @@ void LEDBlinkingTask(void)
 }
 
 
-int main(void)
+// The switches and encoders. These are needed for the first report.
+
+void InitDigitalInputs(void)
+{
+#if QUADRATURE
+	g_digitalInputGroup.ReservePins(g_quadratureInputGroup.GetGPIOMask());
+	g_quadratureInputGroup.Init();
+#endif
+
+	g_digitalInputGroup.Init();
+	g_switchHealth.Init(&g_digitalInputGroup);
+}
+
+
+// Everything the host doesn't need in order to enumerate us and see the buttons. In a fast boot this is put off until
+// the first report has gone out.
+
+void DeferredInit(void)
 {
-	// Init the USB / UART IO.
 	stdio_init_all();
-	adc_init();
-	board_init();
-	tusb_init();
 
 	printf("Centre console online.\n\n");
 
-	// We'll track the time from startup.
-	lastTaskTime = time_us_32();
-
-	// Init our input handlers.
-	g_digitalInputGroup.Init();
 	g_analogueSwitchGroup.Init();
 
+	g_digitalInputGroup.PrintDiagnostics();
+	g_analogueSwitchGroup.PrintDiagnostics();
+#if QUADRATURE
+	g_quadratureInputGroup.PrintDiagnostics();
+#endif
+
+	g_bootProfile.Mark(kBootPhaseDeferredInit);
+	g_bootProfile.Print();
+	g_stackWatermark.Print();
+
 	printf("Initialisation complete.\n");
 
+	g_isDeferredInitComplete = true;
+}
+
+
+int main(void)
+{
+	// Before the stack gets any deeper.
+	g_stackWatermark.Init();
+
+	g_bootProfile.Mark(kBootPhaseMainEntered);
+
+	// This has to come before anything which sets a baud rate.
+	g_clockProfiles.Init();
+
+	// Get onto the bus and reading the buttons first, that is all the host needs to see us. The UART comes up with the
+	// rest.
+	board_init();
+	tusb_init();
+	g_bootProfile.Mark(kBootPhaseUSBStarted);
+
+	InitDigitalInputs();
+	g_bootProfile.Mark(kBootPhaseDigitalReady);
+
+#if !FAST_BOOT
+	DeferredInit();
+#endif
+
+	// We'll track the time from startup.
+	lastTaskTime = time_us_32();
+
 	while (true)
 	{
 		// TinyUSB device task.
@@ -253,14 +608,40 @@ int main(void)
 		LEDBlinkingTask();
 
 		// Check all our switches.
-		if (g_digitalInputGroup.OnTask()) {}
+		if (g_digitalInputGroup.OnTask())
+		{
+			g_switchHealth.OnInputsChanged(g_digitalInputGroup.GetLastChangeTime());
+			NoteUnreportedChanges();
+			CheckHotkeys();
+		}
+		g_switchHealth.OnTask();
+
+#if QUADRATURE
+		// Pick up any spinner or trackball motion.
+		if (g_quadratureInputGroup.OnTask()) {}
+#endif
 
 		// Check the analogue inputs.
-		if (g_analogueSwitchGroup.OnTask()) {}
+		if (g_isDeferredInitComplete && g_analogueSwitchGroup.OnTask()) {}
 
 		// Keep them informed about HID changes.
 		SendHIDTask();
 
+		// Bring up the rest once the host has its first report.
+		if (!g_isDeferredInitComplete &&
+		    (g_bootProfile.HasReached(kBootPhaseFirstReport) || time_us_32() > kDeferredInitTimeoutUS))
+			DeferredInit();
+
+		// Change clock once everything is up, since it upsets the peripherals part way through their setup.
+		if (g_isDeferredInitComplete)
+			ClockProfileTask();
+
+		g_clockProfiles.OnLoop();
+		g_clockProfiles.OnTask();
+
+		// Let us know if the stacks get any deeper.
+		g_stackWatermark.OnTask();
+
 		// Track time.
 		lastTaskTime = time_us_32();
 	}
@@ -0,0 +1,131 @@
+#include "QuadratureInput.h"
+
+#include "hardware/pio.h"
+#include "pico/stdlib.h"
+#include "quadrature_encoder.pio.h"
+#include <stdio.h>
+
+
+void QuadratureInputGroup::Init()
+{
+	// All the encoders share the one copy of the program. It goes at offset 0 for the jump table.
+	pio_add_program(pio0, &quadrature_encoder_program);
+
+	for (size_t i = 0; i < kEncoderCount; i++)
+	{
+		encoders[i].stateMachine = pio_claim_unused_sm(pio0, true);
+		quadrature_encoder_program_init(pio0, encoders[i].stateMachine, encoders[i].gpioPinA);
+
+		encoders[i].count = 0;
+		encoders[i].pendingCounts = 0;
+	}
+}
+
+
+void QuadratureInputGroup::PrintDiagnostics()
+{
+	printf("Quadrature pins:\n\n");
+
+	for (size_t i = 0; i < kEncoderCount; i++)
+	{
+		printf("Init Encoder: %d - GPIO: %d, %d - SM: %d.\n", i, encoders[i].gpioPinA, encoders[i].gpioPinA + 1,
+		    encoders[i].stateMachine);
+	}
+
+	printf("\n");
+}
+
+
+bool QuadratureInputGroup::OnTask()
+{
+	// Default is for nothing to happen.
+	hasStateChanged = false;
+
+	for (size_t i = 0; i < kEncoderCount; i++)
+	{
+		QuadratureInput &encoder = encoders[i];
+
+		// The state machine keeps pushing its count, we only want the most recent one. Once the FIFO fills the newer
+		// counts are dropped, so everything in there is stale. Drain it, then wait for the next push, which only takes
+		// a loop of the program.
+		uint level = pio_sm_get_rx_fifo_level(pio0, encoder.stateMachine);
+		while (level-- > 0)
+			pio_sm_get(pio0, encoder.stateMachine);
+
+		const uint32_t latestCount = pio_sm_get_blocking(pio0, encoder.stateMachine);
+
+		// Unsigned maths so the count can wrap.
+		const int32_t delta = static_cast<int32_t>(latestCount - static_cast<uint32_t>(encoder.count));
+		if (delta != 0)
+		{
+			encoder.count = static_cast<int32_t>(latestCount);
+			hasStateChanged = true;
+
+			// Axes only need the position, the mouse needs every count.
+			if (encoder.output == kQuadratureOutputMouseX || encoder.output == kQuadratureOutputMouseY)
+				encoder.pendingCounts += delta;
+		}
+	}
+
+	return hasStateChanged;
+}
+
+
+uint32_t QuadratureInputGroup::GetGPIOMask() const
+{
+	uint32_t mask = 0;
+
+	for (size_t i = 0; i < kEncoderCount; i++)
+		mask |= (3U << encoders[i].gpioPinA);
+
+	return mask;
+}
+
+
+bool QuadratureInputGroup::HasOutput(QuadratureOutput output) const
+{
+	for (size_t i = 0; i < kEncoderCount; i++)
+	{
+		if (encoders[i].output == output)
+			return true;
+	}
+
+	return false;
+}
+
+
+int8_t QuadratureInputGroup::GetPendingSteps(QuadratureOutput output) const
+{
+	for (size_t i = 0; i < kEncoderCount; i++)
+	{
+		if (encoders[i].output == output)
+			return encoders[i].GetPendingSteps();
+	}
+
+	return 0;
+}
+
+
+void QuadratureInputGroup::ConsumeSteps(QuadratureOutput output, int8_t steps)
+{
+	for (size_t i = 0; i < kEncoderCount; i++)
+	{
+		if (encoders[i].output == output)
+		{
+			encoders[i].ConsumeSteps(steps);
+			return;
+		}
+	}
+}
+
+
+int8_t QuadratureInputGroup::GetPosition(QuadratureOutput output) const
+{
+	for (size_t i = 0; i < kEncoderCount; i++)
+	{
+		if (encoders[i].output == output)
+			return encoders[i].GetPosition();
+	}
+
+	return 0;
+}
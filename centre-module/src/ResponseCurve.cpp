@@ -0,0 +1,41 @@
+#include "ResponseCurve.h"
+
+
+// Being constexpr forces the tables to be built by the compiler, so they end up in flash rather than being filled in
+// at start-up.
+static constexpr ResponseCurveTable kLinearTable{MakeResponseCurveTable(LinearResponse)};
+static constexpr ResponseCurveTable kExponentialTable{MakeResponseCurveTable(ExponentialResponse)};
+static constexpr ResponseCurveTable kSCurveTable{MakeResponseCurveTable(SCurveResponse)};
+static constexpr ResponseCurveTable kAntiDeadzoneTable{MakeResponseCurveTable(AntiDeadzoneResponse)};
+
+// The linear table has to give the same answer as the shift it replaced.
+static_assert(kLinearTable.values[0] == -128, "Linear response curve is wrong at the minimum");
+static_assert(kLinearTable.values[kResponseCurveMidPoint] == 0, "Linear response curve is wrong at the centre");
+static_assert(kLinearTable.values[kResponseCurveMidPoint - 1] == -1, "Linear response curve is wrong below centre");
+static_assert(kLinearTable.values[kResponseCurveTableSize - 1] == 127, "Linear response curve is wrong at the maximum");
+
+static const int8_t *const kResponseCurves[kResponseCurveCount]{
+    kLinearTable.values,
+    kExponentialTable.values,
+    kSCurveTable.values,
+    kAntiDeadzoneTable.values,
+};
+
+static const char *const kResponseCurveNames[kResponseCurveCount]{
+    "Linear",
+    "Exponential",
+    "S-Curve",
+    "Anti-Deadzone",
+};
+
+
+const int8_t *GetResponseCurve(ResponseCurveID curveID)
+{
+	return kResponseCurves[curveID];
+}
+
+
+const char *GetResponseCurveName(ResponseCurveID curveID)
+{
+	return kResponseCurveNames[curveID];
+}
@@ -0,0 +1,153 @@
+#include "SPIAnalogueInput.h"
+
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/spi.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+
+// The transfer count we give the pacing channel. It counts down once per conversion, so it runs for days before it
+// needs restarting.
+static const uint32_t kPacingTransferCount{0xFFFFFFFF};
+
+
+void SPIAnalogueInputGroup::Init()
+{
+	// Round the slots up to a power of two, the spare ones just convert channel 0 again.
+	slotCount = 1;
+	while (slotCount < axisCount)
+		slotCount <<= 1;
+
+	for (size_t i = 0; i < slotCount; i++)
+	{
+		EncodeCommand(i < axisCount ? analogueInputs[i].gpioSwitchId : 0, &commandBuffer[i * kBytesPerConversion]);
+	}
+
+	// Default the raw input values to the mid-position.
+	for (size_t i = 0; i < kMaxAxisCount; i++)
+	{
+		analogueInputs[i].value = AnalogueInput::midPointADCValue;
+		analogueInputs[i].isEnabled = i < axisCount;
+	}
+
+	// Mode 3 keeps the hardware chip select asserted while there is data in the FIFO.
+	spi_init(spi1, kBaudRate);
+	spi_set_format(spi1, 8, SPI_CPOL_1, SPI_CPHA_1, SPI_MSB_FIRST);
+	gpio_set_function(kPinSCK, GPIO_FUNC_SPI);
+	gpio_set_function(kPinTX, GPIO_FUNC_SPI);
+	gpio_set_function(kPinRX, GPIO_FUNC_SPI);
+	gpio_set_function(kPinCSn, GPIO_FUNC_SPI);
+
+	txChannel = dma_claim_unused_channel(true);
+	rxChannel = dma_claim_unused_channel(true);
+	pacingChannel = dma_claim_unused_channel(true);
+	pacingTimer = dma_claim_unused_timer(true);
+
+	const uint ringBits = __builtin_ctz(slotCount * kBytesPerConversion);
+
+	// Commands out. The read address rings around the command buffer.
+	dma_channel_config config = dma_channel_get_default_config(txChannel);
+	channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+	channel_config_set_read_increment(&config, true);
+	channel_config_set_write_increment(&config, false);
+	channel_config_set_ring(&config, false, ringBits);
+	channel_config_set_dreq(&config, spi_get_dreq(spi1, true));
+	dma_channel_configure(
+	    txChannel, &config, &spi_get_hw(spi1)->dr, commandBuffer, kBytesPerConversion, false);
+
+	// Samples in. The write address rings around the sample buffer.
+	config = dma_channel_get_default_config(rxChannel);
+	channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+	channel_config_set_read_increment(&config, false);
+	channel_config_set_write_increment(&config, true);
+	channel_config_set_ring(&config, true, ringBits);
+	channel_config_set_dreq(&config, spi_get_dreq(spi1, false));
+	dma_channel_configure(
+	    rxChannel, &config, sampleBuffer, &spi_get_hw(spi1)->dr, kBytesPerConversion, false);
+
+	triggerMask = (1U << txChannel) | (1U << rxChannel);
+
+	SetSampleRate(sampleRateHz);
+	StartPacing();
+}
+
+
+void SPIAnalogueInputGroup::PrintDiagnostics()
+{
+	printf("SPI analogue pins:\n\n");
+	printf("SCK: %d, TX: %d, RX: %d, CSn: %d.\n", kPinSCK, kPinTX, kPinRX, kPinCSn);
+	printf("Axes: %d, Slots: %d, Sweep rate: %d Hz.\n", axisCount, slotCount, sampleRateHz);
+	printf("\n");
+}
+
+
+void SPIAnalogueInputGroup::SetSampleRate(uint32_t newSampleRateHz)
+{
+	sampleRateHz = newSampleRateHz;
+
+	if (pacingTimer < 0)
+		return;
+
+	// The timer fires at clk_sys * X / Y, we want one conversion per slot per sweep. Y is only 16 bits, so it can't go
+	// below ~1.9k conversions a second at 125MHz. Sweeps of one or two slots end up faster than asked.
+	uint32_t divider = clock_get_hz(clk_sys) / (sampleRateHz * slotCount);
+	if (divider > 0xFFFF)
+		divider = 0xFFFF;
+	else if (divider == 0)
+		divider = 1;
+
+	dma_timer_set_fraction(pacingTimer, 1, divider);
+}
+
+
+void SPIAnalogueInputGroup::StartPacing()
+{
+	dma_channel_config config = dma_channel_get_default_config(pacingChannel);
+	channel_config_set_transfer_data_size(&config, DMA_SIZE_32);
+	channel_config_set_read_increment(&config, false);
+	channel_config_set_write_increment(&config, false);
+	channel_config_set_dreq(&config, dma_get_timer_dreq(pacingTimer));
+	dma_channel_configure(
+	    pacingChannel, &config, &dma_hw->multi_channel_trigger, &triggerMask, kPacingTransferCount, true);
+
+	lastRateCheckCount = 0;
+	lastRateCheckTime = time_us_32();
+}
+
+
+bool SPIAnalogueInputGroup::OnTask()
+{
+	// Once the pacing channel counts down to zero it stops, so kick it off again.
+	if (!dma_channel_is_busy(pacingChannel))
+		StartPacing();
+
+	// Don't decode the slot the DMA is writing into, it would mix the old and new samples.
+	size_t busySlot = slotCount;
+	if (dma_channel_is_busy(rxChannel))
+	{
+		const uintptr_t writeOffset = dma_hw->ch[rxChannel].write_addr - reinterpret_cast<uintptr_t>(sampleBuffer);
+		busySlot = (writeOffset / kBytesPerConversion) & (slotCount - 1);
+	}
+
+	for (size_t i = 0; i < axisCount; i++)
+	{
+		if (analogueInputs[i].isEnabled && i != busySlot)
+		{
+			analogueInputs[i].value = DecodeSample(const_cast<const uint8_t *>(&sampleBuffer[i * kBytesPerConversion]));
+		}
+	}
+
+	// Keep track of the conversion rate the DMA is actually managing.
+	const uint32_t currentTime = time_us_32();
+	if (currentTime - lastRateCheckTime > 1000000)
+	{
+		const uint32_t conversions = kPacingTransferCount - dma_hw->ch[pacingChannel].transfer_count;
+		measuredConversionsPerSecond = static_cast<uint32_t>(
+		    (static_cast<uint64_t>(conversions - lastRateCheckCount) * 1000000) / (currentTime - lastRateCheckTime));
+		lastRateCheckCount = conversions;
+		lastRateCheckTime = currentTime;
+	}
+
+	return true;
+}
@@ -0,0 +1,98 @@
+#include "StackWatermark.h"
+
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include <stdio.h>
+
+
+// Provided by the SDK's linker script. Core 0 runs on the main stack and core 1 has its own.
+extern uint32_t __StackBottom;
+extern uint32_t __StackTop;
+extern uint32_t __StackOneBottom;
+extern uint32_t __StackOneTop;
+
+// Written into the unused stack so we can see how much has been touched.
+static const uint32_t kStackPaint{0xDEADBEEF};
+
+// Stack below the current stack pointer we leave alone while painting, for the calls we are in the middle of.
+static const uint32_t kPaintMargin{64};
+
+
+static uint32_t *GetStackBottom(size_t core)
+{
+	return core == 0 ? &__StackBottom : &__StackOneBottom;
+}
+
+
+static uint32_t *GetStackTop(size_t core)
+{
+	return core == 0 ? &__StackTop : &__StackOneTop;
+}
+
+
+void StackWatermark::Init()
+{
+	uint32_t stackPointer;
+	__asm volatile("mov %0, sp" : "=r"(stackPointer));
+
+	// Core 0 is running on its stack, so only paint up to just below where we are.
+	uint32_t *const paintEnd = reinterpret_cast<uint32_t *>(stackPointer - kPaintMargin);
+	for (uint32_t *word = GetStackBottom(0); word < paintEnd; word++)
+		*word = kStackPaint;
+
+	// Core 1 isn't running yet, so all of its stack is free.
+	for (uint32_t *word = GetStackBottom(1); word < GetStackTop(1); word++)
+		*word = kStackPaint;
+
+	lastCheckTime = time_us_32();
+}
+
+
+uint32_t StackWatermark::GetHighWaterMark(size_t core) const
+{
+	// The stacks grow down, so the first word that isn't paint is the deepest we have been.
+	const uint32_t *word = GetStackBottom(core);
+	while (word < GetStackTop(core) && *word == kStackPaint)
+		word++;
+
+	return reinterpret_cast<uintptr_t>(GetStackTop(core)) - reinterpret_cast<uintptr_t>(word);
+}
+
+
+uint32_t StackWatermark::GetStackSize(size_t core) const
+{
+	return reinterpret_cast<uintptr_t>(GetStackTop(core)) - reinterpret_cast<uintptr_t>(GetStackBottom(core));
+}
+
+
+void StackWatermark::OnTask()
+{
+	const uint32_t currentTime = time_us_32();
+	if (currentTime - lastCheckTime < 1000000)
+		return;
+
+	lastCheckTime = currentTime;
+
+	bool hasGrown = false;
+	for (size_t i = 0; i < kCoreCount; i++)
+	{
+		const uint32_t highWaterMark = GetHighWaterMark(i);
+		if (highWaterMark > lastHighWaterMarks[i])
+		{
+			lastHighWaterMarks[i] = highWaterMark;
+			hasGrown = true;
+		}
+	}
+
+	if (hasGrown)
+		Print();
+}
+
+
+void StackWatermark::Print() const
+{
+	for (size_t i = 0; i < kCoreCount; i++)
+	{
+		printf("Stack core %d: %u / %u bytes used.\n", i, GetHighWaterMark(i), GetStackSize(i));
+	}
+}
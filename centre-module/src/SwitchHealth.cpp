@@ -0,0 +1,188 @@
+#include "SwitchHealth.h"
+#include "ReportBytes.h"
+
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include <stdio.h>
+
+
+// Counters stop at the top rather than wrapping back to zero.
+static inline void SaturatingIncrement(uint16_t &counter)
+{
+	if (counter != UINT16_MAX)
+		counter++;
+}
+
+
+void SwitchHealth::Init(const DigitalInputGroup *newDigitalInputGroup)
+{
+	digitalInputGroup = newDigitalInputGroup;
+	inputCount = digitalInputGroup->GetInputCount();
+
+	Reset();
+}
+
+
+void SwitchHealth::Reset()
+{
+	const uint32_t currentTime = time_us_32();
+
+	for (size_t i = 0; i < inputCount; i++)
+	{
+		const bool isPressed = digitalInputGroup->GetInputStates().Test(i);
+
+		switchStats[i] = SwitchStats{};
+		switchStats[i].minHoldMS = UINT16_MAX;
+		switchStats[i].flags = isPressed ? kSwitchHealthPressed : 0;
+		if (!digitalInputGroup->IsInputInUse(i))
+			switchStats[i].flags |= kSwitchHealthNotInUse;
+
+		switchTracking[i].lastChangeUS = currentTime - kBounceWindowUS;
+		switchTracking[i].pressStartUS = currentTime;
+		switchTracking[i].panelPressesAtLastPress = 0;
+	}
+
+	panelPressCount = 0;
+	lastCheckTime = currentTime;
+}
+
+
+void SwitchHealth::OnInputsChanged(uint32_t timeUS)
+{
+	const InputBitset<DigitalInputGroup::kMaxInputCount> &inputStates = digitalInputGroup->GetInputStates();
+
+	digitalInputGroup->GetChangedInputs().ForEachSetBit(
+	    [this, &inputStates, timeUS](size_t input) { OnChange(input, inputStates.Test(input), timeUS); });
+}
+
+
+void SwitchHealth::OnChange(size_t input, bool isPressed, uint32_t timeUS)
+{
+	SwitchStats &stats = switchStats[input];
+	SwitchTracking &tracking = switchTracking[input];
+
+	const uint32_t sinceLastChange = timeUS - tracking.lastChangeUS;
+	tracking.lastChangeUS = timeUS;
+
+	if (isPressed)
+		stats.flags |= kSwitchHealthPressed;
+	else
+		stats.flags &= ~kSwitchHealthPressed;
+
+	// Too quick for a person, the contacts are bouncing.
+	if (sinceLastChange < kBounceWindowUS)
+	{
+		SaturatingIncrement(stats.bounceCount);
+		return;
+	}
+
+	if (isPressed)
+	{
+		SaturatingIncrement(stats.pressCount);
+		tracking.pressStartUS = timeUS;
+		tracking.panelPressesAtLastPress = ++panelPressCount;
+		stats.flags &= ~kSwitchHealthStuckOff;
+	}
+	else
+	{
+		const uint32_t holdUS = timeUS - tracking.pressStartUS;
+		if (holdUS < kChatterHoldUS)
+			SaturatingIncrement(stats.chatterCount);
+
+		const uint32_t holdMS = holdUS / 1000;
+		const uint16_t clampedHoldMS = holdMS > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(holdMS);
+		if (clampedHoldMS < stats.minHoldMS)
+			stats.minHoldMS = clampedHoldMS;
+		if (clampedHoldMS > stats.maxHoldMS)
+			stats.maxHoldMS = clampedHoldMS;
+
+		stats.flags &= ~kSwitchHealthStuckOn;
+	}
+}
+
+
+void SwitchHealth::OnTask()
+{
+	const uint32_t currentTime = time_us_32();
+	if (currentTime - lastCheckTime < 1000000)
+		return;
+
+	lastCheckTime = currentTime;
+
+	for (size_t i = 0; i < inputCount; i++)
+	{
+		SwitchStats &stats = switchStats[i];
+		const SwitchTracking &tracking = switchTracking[i];
+		const uint8_t oldFlags = stats.flags;
+
+		// A reserved pin would only ever look stuck off.
+		if (stats.flags & kSwitchHealthNotInUse)
+			continue;
+
+		if (stats.flags & kSwitchHealthPressed)
+		{
+			if (currentTime - tracking.pressStartUS > kStuckOnUS)
+				stats.flags |= kSwitchHealthStuckOn | kSwitchHealthWasStuckOn;
+		}
+		else if (stats.pressCount >= kStuckOffMinPresses)
+		{
+			// How many presses of the panel this switch usually goes without.
+			const uint32_t averageGap = tracking.panelPressesAtLastPress / stats.pressCount;
+			const uint32_t gapThreshold = averageGap * kStuckOffGapMultiple;
+			const uint32_t threshold = gapThreshold > kStuckOffPanelPresses ? gapThreshold : kStuckOffPanelPresses;
+
+			if (panelPressCount - tracking.panelPressesAtLastPress > threshold)
+				stats.flags |= kSwitchHealthStuckOff;
+		}
+
+		// Let whoever is on the UART know as soon as it happens.
+		if ((stats.flags & ~oldFlags) & kSwitchHealthStuckOn)
+			printf("Switch %s looks stuck on.\n", digitalInputGroup->GetInputName(i));
+		if ((stats.flags & ~oldFlags) & kSwitchHealthStuckOff)
+			printf("Switch %s looks stuck off.\n", digitalInputGroup->GetInputName(i));
+	}
+}
+
+
+uint16_t SwitchHealth::GetReport(uint8_t *buffer, uint16_t length) const
+{
+	if (length < kReportHeaderBytes)
+		return 0;
+
+	const size_t firstInput = reportFirstInput < inputCount ? reportFirstInput : 0;
+	size_t count = (length - kReportHeaderBytes) / kReportBytesPerSwitch;
+	if (count > inputCount - firstInput)
+		count = inputCount - firstInput;
+
+	uint8_t *write = buffer;
+	*write++ = static_cast<uint8_t>(firstInput);
+	*write++ = static_cast<uint8_t>(inputCount);
+	*write++ = static_cast<uint8_t>(count);
+
+	for (size_t i = firstInput; i < firstInput + count; i++)
+	{
+		const SwitchStats &stats = switchStats[i];
+
+		write = WriteUInt16(write, stats.pressCount);
+		write = WriteUInt16(write, stats.bounceCount);
+		write = WriteUInt16(write, stats.chatterCount);
+		write = WriteUInt16(write, stats.minHoldMS);
+		write = WriteUInt16(write, stats.maxHoldMS);
+		*write++ = stats.flags;
+		*write++ = static_cast<uint8_t>(digitalInputGroup->GetInputGPIO(i));
+	}
+
+	return PadReport(buffer, write, length);
+}
+
+
+void SwitchHealth::SetReport(const uint8_t *buffer, uint16_t length)
+{
+	if (length < 1)
+		return;
+
+	reportFirstInput = buffer[0];
+
+	if (length > 1 && buffer[1] == 1)
+		Reset();
+}
@@ -52,11 +52,54 @@ uint8_t const* tud_descriptor_device_cb(void)
 // HID Report Descriptor
 //--------------------------------------------------------------------+
 
+// A vendor defined collection holding a feature report of bytes, for diagnostics
+#define VENDOR_FEATURE_REPORT_DESC(usage, ...) \
+	HID_USAGE_PAGE_N ( HID_USAGE_PAGE_VENDOR, 2            ),\
+	HID_USAGE        ( usage                               ),\
+	HID_COLLECTION   ( HID_COLLECTION_APPLICATION          ),\
+		__VA_ARGS__ \
+		HID_USAGE        ( usage                           ),\
+		HID_LOGICAL_MIN  ( 0x00                            ),\
+		HID_LOGICAL_MAX_N( 0xff, 2                         ),\
+		HID_REPORT_SIZE  ( 8                               ),\
+		HID_REPORT_COUNT ( FEATURE_REPORT_SIZE             ),\
+		HID_FEATURE      ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ),\
+	HID_COLLECTION_END
+
+// The latency probe comes in as a feature or output report, and the echo goes back as an input report
+#define LATENCY_PROBE_REPORT_DESC(...) \
+	HID_USAGE_PAGE_N ( HID_USAGE_PAGE_VENDOR, 2            ),\
+	HID_USAGE        ( 0x03                                ),\
+	HID_COLLECTION   ( HID_COLLECTION_APPLICATION          ),\
+		__VA_ARGS__ \
+		HID_LOGICAL_MIN  ( 0x00                            ),\
+		HID_LOGICAL_MAX_N( 0xff, 2                         ),\
+		HID_REPORT_SIZE  ( 8                               ),\
+		HID_USAGE        ( 0x03                            ),\
+		HID_REPORT_COUNT ( LATENCY_PROBE_ECHO_SIZE         ),\
+		HID_INPUT        ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ),\
+		HID_USAGE        ( 0x03                            ),\
+		HID_REPORT_COUNT ( LATENCY_PROBE_SIZE              ),\
+		HID_OUTPUT       ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ),\
+		HID_USAGE        ( 0x03                            ),\
+		HID_FEATURE      ( HID_DATA | HID_VARIABLE | HID_ABSOLUTE ),\
+	HID_COLLECTION_END
+
+// The first player's instance carries everything
 uint8_t const desc_hid_report[] =
 {
 	TUD_HID_REPORT_DESC_KEYBOARD(HID_REPORT_ID(REPORT_ID_KEYBOARD)),
 	TUD_HID_REPORT_DESC_MOUSE(HID_REPORT_ID(REPORT_ID_MOUSE)),
 	TUD_HID_REPORT_DESC_CONSUMER(HID_REPORT_ID(REPORT_ID_CONSUMER_CONTROL)),
+	TUD_HID_REPORT_DESC_GAMEPAD(HID_REPORT_ID(REPORT_ID_GAMEPAD)),
+	VENDOR_FEATURE_REPORT_DESC(0x01, HID_REPORT_ID(REPORT_ID_SWITCH_HEALTH)),
+	VENDOR_FEATURE_REPORT_DESC(0x02, HID_REPORT_ID(REPORT_ID_INPUT_HISTORY)),
+	LATENCY_PROBE_REPORT_DESC(HID_REPORT_ID(REPORT_ID_LATENCY_PROBE))
+};
+
+// The other players only have a gamepad, with the same report ID so the reports are encoded the same way
+uint8_t const desc_hid_report_gamepad[] =
+{
 	TUD_HID_REPORT_DESC_GAMEPAD(HID_REPORT_ID(REPORT_ID_GAMEPAD))
 };
 
@@ -66,31 +109,39 @@ uint8_t const desc_hid_report[] =
 
 uint8_t const* tud_hid_descriptor_report_cb(uint8_t instance)
 {
-	(void)instance;
-	return desc_hid_report;
+	return (instance == 0) ? desc_hid_report : desc_hid_report_gamepad;
 }
 
 //--------------------------------------------------------------------+
 // Configuration Descriptor
 //--------------------------------------------------------------------+
 
+// One interface for each player
 enum
 {
 	ITF_NUM_HID,
-	ITF_NUM_TOTAL
+	ITF_NUM_TOTAL = ITF_NUM_HID + CFG_TUD_HID
 };
 
-#define  CONFIG_TOTAL_LEN  (TUD_CONFIG_DESC_LEN + TUD_HID_DESC_LEN)
+#define  CONFIG_TOTAL_LEN  (TUD_CONFIG_DESC_LEN + CFG_TUD_HID * TUD_HID_DESC_LEN)
 
 #define EPNUM_HID   0x81
 
+// Interface number, string index, protocol, report descriptor len, EP In address, size & polling interval
+#define PLAYER_HID_DESCRIPTOR(player) \
+	TUD_HID_DESCRIPTOR(ITF_NUM_HID + (player), 0, HID_ITF_PROTOCOL_NONE, sizeof(desc_hid_report_gamepad), EPNUM_HID + (player), CFG_TUD_HID_EP_BUFSIZE, 5)
+
 uint8_t const desc_configuration[] =
 {
 	// Config number, interface count, string index, total length, attribute, power in mA
 	TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL, 0, CONFIG_TOTAL_LEN, TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, 100),
 
 	// Interface number, string index, protocol, report descriptor len, EP In address, size & polling interval
-	TUD_HID_DESCRIPTOR(ITF_NUM_HID, 0, HID_ITF_PROTOCOL_NONE, sizeof(desc_hid_report), EPNUM_HID, CFG_TUD_HID_EP_BUFSIZE, 5)
+	TUD_HID_DESCRIPTOR(ITF_NUM_HID, 0, HID_ITF_PROTOCOL_NONE, sizeof(desc_hid_report), EPNUM_HID, CFG_TUD_HID_EP_BUFSIZE, 5),
+
+#if CFG_TUD_HID > 1
+	PLAYER_HID_DESCRIPTOR(1),
+#endif
 };
 
 #if TUD_OPT_HIGH_SPEED
@@ -162,7 +213,7 @@ uint8_t const* tud_descriptor_configuration_cb(uint8_t index)
 
 // array of pointer to string descriptors
 
-char const* string_desc_arr[] =
+char const* const string_desc_arr[] =
 {
 	(const char[])
 {